@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "arena.h"
+#include "flat_ast.h"
+#include "lexer.h"
+#include "module_collector.h"
+#include "name_resolution.h"
+#include "node_counter.h"
+#include "parser.h"
+#include "scope.h"
+#include "scan.h"
+#include "source_file.h"
+#include "source_gen.h"
+#include "token.h"
+#include "token_buffer.h"
+#include "token_type.h"
+
+// Usage: arco_bench_frontend [--size=<MiB>] [--runs=<n>] [--filter=<substring>] [--csv]
+//
+// Generates sources of every shape in source_gen.h and reports throughput of the lexer
+// (both modes), batch tokenization, parsing an existing token buffer, parsing from scratch,
+// collecting and resolving names, walking the AST with virtual and with switch based dispatch
+// and flattening the AST, followed by the memory per node of the pointer tree and the flat AST.
+// Every number is the best of --runs runs.
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    size_t size = 8 * 1024 * 1024;
+    int runs = 5;
+    std::string filter;
+    bool csv = false;
+};
+
+struct Result {
+    double seconds = 1e30;
+    size_t tokens = 0;
+    size_t nodes = 0;
+};
+
+static Options parse_options(const int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--size=")) {
+            opts.size = std::strtoul(arg.c_str() + 7, nullptr, 10) * 1024 * 1024;
+        } else if (arg.starts_with("--runs=")) {
+            opts.runs = std::max(1, std::atoi(arg.c_str() + 7));
+        } else if (arg.starts_with("--filter=")) {
+            opts.filter = arg.substr(9);
+        } else if (arg == "--csv") {
+            opts.csv = true;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            std::exit(1);
+        }
+    }
+    return opts;
+}
+
+// Runs `body` opts.runs times and keeps the fastest run. `body` returns the result of one run
+// with everything but the timing filled in.
+template<typename F>
+static Result best_of(const Options& opts, F body) {
+    Result best;
+    for (int run = 0; run < opts.runs; run++) {
+        const auto start = Clock::now();
+        Result r = body();
+        r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (r.seconds < best.seconds) {
+            best = r;
+        }
+    }
+    return best;
+}
+
+static Result lex(const Options& opts, SourceFile& src, const LexMode mode) {
+    return best_of(opts, [&] {
+        Result r;
+        Lexer lexer(src, mode);
+        while (lexer.advance().type != TokenType::Eof) {
+            r.tokens++;
+        }
+        return r;
+    });
+}
+
+static Result tokenize(const Options& opts, SourceFile& src) {
+    return best_of(opts, [&] {
+        const TokenBuffer tokens(src);
+        return Result{0, tokens.size(), 0};
+    });
+}
+
+static size_t count_nodes(const std::vector<StmtPtr>& ast) {
+    NodeCounter counter;
+    for (const auto& node : ast) {
+        node->accept(counter);
+    }
+    return counter.count;
+}
+
+// Releasing the arena isn't part of the measurement
+static Result parse(const Options& opts, SourceFile& src, const TokenBuffer* tokens) {
+    Result best;
+    for (int run = 0; run < opts.runs; run++) {
+        Arena arena;
+        const auto start = Clock::now();
+        auto ast = tokens ? parse_file(*tokens, arena) : parse_file(src, arena);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds < best.seconds) {
+            best = {seconds, 0, count_nodes(ast)};
+        }
+    }
+    return best;
+}
+
+// Module collection and name resolution on a freshly parsed AST, as both add to the scopes.
+// Empty for shapes that aren't valid programs.
+static std::optional<Result> resolve(const Options& opts, const TokenBuffer& tokens) {
+    Result best;
+    for (int run = 0; run < opts.runs; run++) {
+        Arena arena;
+        auto ast = parse_file(tokens, arena);
+        Scope module_scope(Scope::Kind::Module, arena);
+        const auto start = Clock::now();
+        try {
+            ModuleCollector mc(module_scope);
+            for (const auto& node : ast) {
+                mc.dispatch(*node);
+            }
+            NameResolution nr(&module_scope);
+            for (const auto& node : ast) {
+                nr.dispatch(*node);
+            }
+        } catch (const std::exception&) {
+            return {};
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds < best.seconds) {
+            best = {seconds, 0, count_nodes(ast)};
+        }
+    }
+    return best;
+}
+
+static Result flatten(const Options& opts, const std::vector<StmtPtr>& ast) {
+    return best_of(opts, [&] {
+        const FlatAst flat = flatten(ast);
+        return Result{0, 0, flat.size()};
+    });
+}
+
+// Walks the whole AST once per run, through the virtual visitor or the switch based one
+template<typename Counter>
+static Result walk(const Options& opts, const std::vector<StmtPtr>& ast) {
+    return best_of(opts, [&] {
+        Counter counter;
+        for (const auto& node : ast) {
+            if constexpr (std::is_base_of_v<Visitor, Counter>) {
+                node->accept(counter);
+            } else {
+                counter.dispatch(*node);
+            }
+        }
+        return Result{0, 0, counter.count};
+    });
+}
+
+static void report(const Options& opts, const std::string& shape, const std::string& name,
+                   const size_t bytes, Result r, const size_t tokens) {
+    if (r.tokens == 0) {
+        r.tokens = tokens;
+    }
+    const double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    if (opts.csv) {
+        std::printf("%s,%s,%zu,%.6f,%.1f,%.0f,%.0f\n", shape.c_str(), name.c_str(), bytes, r.seconds,
+                    mb / r.seconds, r.tokens / r.seconds, r.nodes / r.seconds);
+        return;
+    }
+    std::printf("  %-16s %9.1f MB/s %9.2f Mtokens/s", name.c_str(), mb / r.seconds, r.tokens / r.seconds / 1e6);
+    if (r.nodes) {
+        std::printf(" %9.2f Mnodes/s", r.nodes / r.seconds / 1e6);
+    }
+    std::printf("\n");
+}
+
+int main(const int argc, char** argv) {
+    const Options opts = parse_options(argc, argv);
+    if (opts.csv) {
+        std::printf("shape,benchmark,bytes,seconds,mb_per_s,tokens_per_s,nodes_per_s\n");
+    }
+    for (const auto& shape : source_shapes()) {
+        if (!opts.filter.empty() && std::string(shape.name).find(opts.filter) == std::string::npos) {
+            continue;
+        }
+        SourceFile src(shape.generate(opts.size));
+        const size_t bytes = src.text().size();
+        const TokenBuffer tokens(src);
+        const size_t token_count = tokens.size();
+
+        if (!opts.csv) {
+            std::printf("%s (%.1f MiB, %zu tokens)\n", shape.name, bytes / (1024.0 * 1024.0), token_count);
+        }
+        report(opts, shape.name, "lex/scalar", bytes, lex(opts, src, LexMode::Scalar), token_count);
+        report(opts, shape.name, std::string("lex/") + simd_scanner().name, bytes, lex(opts, src, LexMode::Simd), token_count);
+        report(opts, shape.name, "tokenize", bytes, tokenize(opts, src), token_count);
+        report(opts, shape.name, "parse/tokens", bytes, parse(opts, src, &tokens), token_count);
+        report(opts, shape.name, "parse/file", bytes, parse(opts, src, nullptr), token_count);
+        if (const auto r = resolve(opts, tokens)) {
+            report(opts, shape.name, "resolve", bytes, *r, token_count);
+        }
+
+        Arena arena;
+        const auto ast = parse_file(tokens, arena);
+        report(opts, shape.name, "walk/virtual", bytes, walk<NodeCounter>(opts, ast), token_count);
+        report(opts, shape.name, "walk/switch", bytes, walk<SwitchNodeCounter>(opts, ast), token_count);
+        report(opts, shape.name, "flatten", bytes, flatten(opts, ast), token_count);
+        if (!opts.csv) {
+            const FlatAst flat = flatten(ast);
+            const auto nodes = static_cast<double>(flat.size());
+            std::printf("  %-16s %9.1f B/node (tree) %9.1f B/node (flat)\n", "memory",
+                        arena.bytes_allocated() / nodes, flat.bytes() / nodes);
+        }
+    }
+    return 0;
+}
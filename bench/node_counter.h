@@ -0,0 +1,177 @@
+#pragma once
+#include <cstddef>
+
+#include "expr_nodes.h"
+#include "node_visitor.h"
+#include "stmt_nodes.h"
+#include "visitor.h"
+
+// Counts every node of an AST through the virtual Visitor
+struct NodeCounter final : Visitor {
+    size_t count = 0;
+
+    void visit(TypeAnno &) override { count++; }
+
+    void visit(ParenExpr &expr) override { count++; expr.expr->accept(*this); }
+
+    void visit(BlockExpr &expr) override {
+        count++;
+        for (const auto& stmt : expr.body) {
+            stmt->accept(*this);
+        }
+    }
+
+    void visit(UnaryExpr &expr) override { count++; expr.operand->accept(*this); }
+
+    void visit(BinaryExpr &expr) override {
+        count++;
+        expr.lhs->accept(*this);
+        expr.rhs->accept(*this);
+    }
+
+    void visit(IdExpr &) override { count++; }
+    void visit(IntConst &) override { count++; }
+    void visit(FloatConst &) override { count++; }
+    void visit(CharConst &) override { count++; }
+    void visit(StringConst &) override { count++; }
+    void visit(BoolConst &) override { count++; }
+
+    void visit(FunCall &expr) override {
+        count++;
+        for (const auto& arg : expr.args) {
+            arg->accept(*this);
+        }
+    }
+
+    void visit(IfElseExpr &expr) override {
+        count++;
+        expr.condition->accept(*this);
+        expr.if_branch->accept(*this);
+        if (expr.else_branch.has_value()) {
+            expr.else_branch.value()->accept(*this);
+        }
+    }
+
+    void visit(WhileExpr &expr) override {
+        count++;
+        expr.condition->accept(*this);
+        expr.body->accept(*this);
+    }
+
+    void visit(ExprStmt &stmt) override { count++; stmt.expr->accept(*this); }
+
+    void visit(VarInit &stmt) override {
+        count++;
+        if (stmt.anno.has_value()) {
+            stmt.anno->accept(*this);
+        }
+        stmt.val->accept(*this);
+    }
+
+    void visit(Assignment &stmt) override { count++; stmt.val->accept(*this); }
+
+    void visit(DefArg &arg) override { count++; arg.anno.accept(*this); }
+
+    void visit(FunSignature &signature) override {
+        count++;
+        for (auto& arg : signature.args) {
+            arg.accept(*this);
+        }
+        signature.anno.accept(*this);
+    }
+
+    void visit(FunDef &def) override {
+        count++;
+        def.signature.accept(*this);
+        def.body->accept(*this);
+    }
+
+    void visit(ExternalStmt &stmt) override { count++; stmt.signature.accept(*this); }
+
+    void visit(ImportStmt &) override { count++; }
+};
+
+// Same traversal as NodeCounter, dispatched on the node kind
+struct SwitchNodeCounter final : NodeVisitor<SwitchNodeCounter> {
+    size_t count = 0;
+
+    void visit(TypeAnno &) { count++; }
+
+    void visit(ParenExpr &expr) { count++; dispatch(*expr.expr); }
+
+    void visit(BlockExpr &expr) {
+        count++;
+        for (const auto& stmt : expr.body) {
+            dispatch(*stmt);
+        }
+    }
+
+    void visit(UnaryExpr &expr) { count++; dispatch(*expr.operand); }
+
+    void visit(BinaryExpr &expr) {
+        count++;
+        dispatch(*expr.lhs);
+        dispatch(*expr.rhs);
+    }
+
+    void visit(IdExpr &) { count++; }
+    void visit(IntConst &) { count++; }
+    void visit(FloatConst &) { count++; }
+    void visit(CharConst &) { count++; }
+    void visit(StringConst &) { count++; }
+    void visit(BoolConst &) { count++; }
+
+    void visit(FunCall &expr) {
+        count++;
+        for (const auto& arg : expr.args) {
+            dispatch(*arg);
+        }
+    }
+
+    void visit(IfElseExpr &expr) {
+        count++;
+        dispatch(*expr.condition);
+        dispatch(*expr.if_branch);
+        if (expr.else_branch.has_value()) {
+            dispatch(*expr.else_branch.value());
+        }
+    }
+
+    void visit(WhileExpr &expr) {
+        count++;
+        dispatch(*expr.condition);
+        dispatch(*expr.body);
+    }
+
+    void visit(ExprStmt &stmt) { count++; dispatch(*stmt.expr); }
+
+    void visit(VarInit &stmt) {
+        count++;
+        if (stmt.anno.has_value()) {
+            visit(*stmt.anno);
+        }
+        dispatch(*stmt.val);
+    }
+
+    void visit(Assignment &stmt) { count++; dispatch(*stmt.val); }
+
+    void visit(DefArg &arg) { count++; visit(arg.anno); }
+
+    void visit(FunSignature &signature) {
+        count++;
+        for (auto& arg : signature.args) {
+            visit(arg);
+        }
+        visit(signature.anno);
+    }
+
+    void visit(FunDef &def) {
+        count++;
+        visit(def.signature);
+        dispatch(*def.body);
+    }
+
+    void visit(ExternalStmt &stmt) { count++; visit(stmt.signature); }
+
+    void visit(ImportStmt &) { count++; }
+};
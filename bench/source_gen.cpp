@@ -0,0 +1,103 @@
+#include "source_gen.h"
+
+namespace {
+
+// Appends lines until the total size (including newlines) reaches `bytes`
+struct Lines {
+    std::vector<std::string> lines;
+    size_t size = 0;
+
+    void add(std::string line) {
+        size += line.size() + 1;
+        lines.push_back(std::move(line));
+    }
+};
+
+// Deterministic identifiers of varying length
+std::string identifier(const size_t i) {
+    static const char* parts[] = {"alpha", "beta", "gamma_delta", "x", "counter", "value_with_a_long_name", "q"};
+    return std::string(parts[i % 7]) + "_" + std::to_string(i % 1000);
+}
+
+}
+
+std::vector<std::string> identifier_soup(const size_t bytes) {
+    static const char* ops[] = {" + ", " * ", " - ", " / ", " < ", " == ", " and ", " or "};
+    Lines out;
+    for (size_t i = 0; out.size < bytes; i++) {
+        std::string line = "let " + identifier(i) + " = " + identifier(i + 1);
+        for (size_t j = 0; j < 12; j++) {
+            line += ops[(i + j) % 8] + identifier(i * 13 + j);
+        }
+        out.add(std::move(line));
+    }
+    return std::move(out.lines);
+}
+
+std::vector<std::string> deep_nesting(const size_t bytes) {
+    constexpr int depth = 48;
+    Lines out;
+    for (size_t i = 0; out.size < bytes; i++) {
+        out.add("fun nested_" + std::to_string(i) + "(x of int) of int = {");
+        for (int d = 0; d < depth; d++) {
+            const std::string indent(2 * d + 2, ' ');
+            out.add(indent + (d % 2 ? "{" : "if x > " + std::to_string(d) + " then {"));
+            out.add(indent + "  let v" + std::to_string(d) + " = x + " + std::to_string(d));
+        }
+        std::string expr = "x";
+        for (int d = 0; d < 16; d++) {
+            expr = "(" + expr + " * " + std::to_string(d + 1) + " + v" + std::to_string(depth - 1) + ")";
+        }
+        out.add(std::string(2 * depth + 2, ' ') + expr);
+        for (int d = depth - 1; d >= 0; d--) {
+            out.add(std::string(2 * d + 2, ' ') + (d % 2 ? "}" : "} else { 0; }"));
+        }
+        out.add("}");
+    }
+    return std::move(out.lines);
+}
+
+std::vector<std::string> short_functions(const size_t bytes) {
+    Lines out;
+    for (size_t i = 0; out.size < bytes; i++) {
+        const std::string n = std::to_string(i);
+        out.add("fun f" + n + "(a of int, b of int) of int = a * " + n + " + b");
+    }
+    return std::move(out.lines);
+}
+
+std::vector<std::string> large_strings(const size_t bytes) {
+    const std::string text(1000, 's');
+    Lines out;
+    for (size_t i = 0; out.size < bytes; i++) {
+        const std::string escape = i % 4 == 0 ? "\\t\\\"quoted\\\"\\n" : "";
+        out.add("let s" + std::to_string(i) + " = \"" + text + escape + text + "\"");
+    }
+    return std::move(out.lines);
+}
+
+std::vector<std::string> mixed(const size_t bytes) {
+    Lines out;
+    for (size_t i = 0; out.size < bytes; i++) {
+        const std::string n = std::to_string(i);
+        out.add("fun generated_function_" + n + "(first_argument of int, second of float) of int = {");
+        out.add("    let message = \"some reasonably long string literal number " + n + "\\n\"");
+        out.add("    var counter = first_argument * 1234567 + " + n + "   # trailing comment");
+        out.add("    while counter < 100000 { counter = counter + generated_function_" + n + "(1, 2.5); }");
+        out.add("    counter");
+        out.add("}");
+        out.add("");
+    }
+    return std::move(out.lines);
+}
+
+const std::vector<SourceShape>& source_shapes() {
+    static const std::vector<SourceShape> shapes = {
+        {"identifier_soup", identifier_soup},
+        {"deep_nesting", deep_nesting},
+        {"short_functions", short_functions},
+        {"large_strings", large_strings},
+        {"mixed", mixed},
+    };
+    return shapes;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Synthetic Arco sources of a given shape, roughly `bytes` large. All of them parse.
+struct SourceShape {
+    const char* name;
+    std::vector<std::string> (*generate)(size_t bytes);
+};
+
+// Long lines of identifiers and operators
+std::vector<std::string> identifier_soup(size_t bytes);
+
+// Deeply nested blocks, if-else expressions and parentheses
+std::vector<std::string> deep_nesting(size_t bytes);
+
+// Many one-line functions
+std::vector<std::string> short_functions(size_t bytes);
+
+// Few tokens, mostly long string literals (some with escape sequences)
+std::vector<std::string> large_strings(size_t bytes);
+
+// Something closer to handwritten code: functions with loops, calls, comments and literals
+std::vector<std::string> mixed(size_t bytes);
+
+const std::vector<SourceShape>& source_shapes();
@@ -0,0 +1,44 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+static constexpr size_t max_chunk_size = 4 * 1024 * 1024;
+
+static std::byte* align_up(std::byte* p, const size_t alignment) {
+    const auto addr = reinterpret_cast<uintptr_t>(p);
+    return p + ((alignment - addr % alignment) % alignment);
+}
+
+std::string_view Arena::copy(const std::string_view str) {
+    if (str.empty()) {
+        return {};
+    }
+    auto* mem = static_cast<char*>(allocate(str.size(), 1));
+    std::memcpy(mem, str.data(), str.size());
+    return {mem, str.size()};
+}
+
+void* Arena::do_allocate(const size_t bytes, const size_t alignment) {
+    allocated += bytes;
+    std::byte* p = cur ? align_up(cur, alignment) : nullptr;
+    if (!p || bytes > static_cast<size_t>(end - p)) {
+        // Big allocations get their own chunk, so the rest of the current one isn't wasted
+        if (bytes + alignment > next_chunk_size / 4) {
+            return align_up(new_chunk(bytes + alignment), alignment);
+        }
+        cur = new_chunk(next_chunk_size);
+        end = cur + next_chunk_size;
+        next_chunk_size = std::min(next_chunk_size * 2, max_chunk_size);
+        p = align_up(cur, alignment);
+    }
+    cur = p + bytes;
+    return p;
+}
+
+std::byte* Arena::new_chunk(const size_t size) {
+    reserved += size;
+    chunks.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+    return chunks.back().get();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// AST nodes are never destroyed one by one. They, their vectors and their scopes all come from
+// the Arena of the Module that owns the AST, which releases everything at once.
+struct ArenaDeleter {
+    void operator()(const void*) const noexcept {}
+};
+
+template<typename T>
+using NodePtr = std::unique_ptr<T, ArenaDeleter>;
+
+// Bump-pointer allocator. Deallocation is a no-op, memory is returned when the Arena is destroyed.
+class Arena final : public std::pmr::memory_resource {
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template<typename T, typename... Args>
+    NodePtr<T> make(Args&&... args) {
+        return NodePtr<T>(new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+    }
+
+    std::string_view copy(std::string_view str);
+
+    // Bytes handed out so far, and bytes reserved from the system
+    size_t bytes_allocated() const { return allocated; }
+    size_t bytes_reserved() const { return reserved; }
+
+private:
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    std::byte* cur = nullptr;
+    std::byte* end = nullptr;
+    size_t next_chunk_size = 64 * 1024;
+    size_t allocated = 0;
+    size_t reserved = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+    std::byte* new_chunk(size_t size);
+};
@@ -1,12 +1,8 @@
 #pragma once
-#include <memory>
+#include "arena.h"
 #include "location.h"
+#include "node_kind.h"
 
-namespace llvm {
-class Value;
-}
-
-struct CodegenVisitor;
 struct Type;
 struct Visitor;
 struct Scope;
@@ -15,17 +11,18 @@ struct Scope;
 struct Expr {
     virtual ~Expr() = default;
 
+    // Lets NodeVisitor dispatch without virtual calls
+    NodeKind kind;
     Location loc;
     Scope* parent_scope = nullptr;
     Type* type = nullptr;
 
-    explicit Expr(const Location &loc): loc(loc) {}
+    Expr(const NodeKind kind, const Location &loc): kind(kind), loc(loc) {}
 
     virtual void accept(Visitor&) = 0;
-    virtual llvm::Value* codegen_accept(CodegenVisitor& visitor) = 0;
 };
 
-using ExprPtr = std::unique_ptr<Expr>;
+using ExprPtr = NodePtr<Expr>;
 
 struct ParenExpr;
 struct UnaryExpr;
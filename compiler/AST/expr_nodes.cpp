@@ -1,9 +1,7 @@
 #include "expr_nodes.h"
 #include "visitor.h"
-#include "codegen_visitor.h"
 
 void ParenExpr::accept(Visitor& visitor) { return visitor.visit(*this); }
-llvm::Value* ParenExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 std::string str_of_unary_op(UnaryOp op) {
     using enum UnaryOp;
@@ -16,13 +14,10 @@ std::string str_of_unary_op(UnaryOp op) {
 }
 
 void IdExpr::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* IdExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void FunCall::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* FunCall::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void UnaryExpr::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* UnaryExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 std::string str_of_binary_op(BinaryOp op) {
     using enum BinaryOp;
@@ -46,28 +41,19 @@ std::string str_of_binary_op(BinaryOp op) {
 }
 
 void BinaryExpr::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* BinaryExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void BlockExpr::accept(Visitor& visitor) { return visitor.visit(*this); }
-llvm::Value* BlockExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void IfElseExpr::accept(Visitor& visitor) { return visitor.visit(*this); }
-llvm::Value* IfElseExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void WhileExpr::accept(Visitor &visitor) { return visitor.visit(*this); }
-llvm::Value* WhileExpr::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void IntConst::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* IntConst::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void FloatConst::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* FloatConst::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void CharConst::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* CharConst::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void StringConst::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* StringConst::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
 
 void BoolConst::accept(Visitor& visitor)  { return visitor.visit(*this); }
-llvm::Value* BoolConst::codegen_accept(CodegenVisitor& visitor)  { return visitor.visit(*this); }
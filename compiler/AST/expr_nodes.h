@@ -1,4 +1,8 @@
 #pragma once
+#include <charconv>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
 #include <vector>
 #include "expr.h"
 #include "stmt.h"
@@ -10,10 +14,9 @@
 struct ParenExpr final : Expr {
     ExprPtr expr;
     ParenExpr(const Location& loc, ExprPtr expr)
-        : Expr(loc), expr(std::move(expr)) {}
+        : Expr(NodeKind::Paren, loc), expr(std::move(expr)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 enum class UnaryOp {Minus, Plus, Not};
@@ -35,10 +38,9 @@ struct UnaryExpr final : Expr {
     ExprPtr operand;
 
     explicit UnaryExpr(const Token& op, ExprPtr operand)
-        : Expr(op.loc), op(unary_op_of_type(op)), operand(std::move(operand)) {}
+        : Expr(NodeKind::Unary, op.loc), op(unary_op_of_type(op)), operand(std::move(operand)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 enum class BinaryOp {
@@ -72,12 +74,13 @@ static BinaryOp binary_op_of_type(const Token& t) {
 }
 
 struct IdExpr final : Expr {
-    std::string id;
+    Ident id;
+    // Set by name resolution
+    Symbol* sym = nullptr;
     explicit IdExpr(const Token& id)
-        : Expr(id.loc), id(id.lexeme) {}
+        : Expr(NodeKind::Id, id.loc), id(id.ident) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 
@@ -87,34 +90,39 @@ struct BinaryExpr final : Expr {
     ExprPtr rhs;
 
     BinaryExpr(const Token& op, ExprPtr lhs, ExprPtr rhs)
-        : Expr(op.loc), op(binary_op_of_type(op)), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+        : Expr(NodeKind::Binary, op.loc), op(binary_op_of_type(op)), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 
 struct FunCall final : Expr {
-    std::string callee;
-    std::vector<ExprPtr> args;
+    // The module in module.callee(...), empty for calls without one
+    Ident qualifier;
+    Ident callee;
+    std::pmr::vector<ExprPtr> args;
+    // Set by name resolution, stays nullptr for printf
+    Symbol* sym = nullptr;
 
-    FunCall(const Token& callee, std::vector<ExprPtr> args)
-        : Expr(callee.loc), callee(callee.lexeme), args(std::move(args)) {}
+    FunCall(const Token& callee, std::pmr::vector<ExprPtr> args)
+        : Expr(NodeKind::FunCall, callee.loc), callee(callee.ident), args(std::move(args)) {}
+
+    FunCall(const Token& qualifier, const Token& callee, std::pmr::vector<ExprPtr> args)
+        : Expr(NodeKind::FunCall, qualifier.loc), qualifier(qualifier.ident), callee(callee.ident),
+          args(std::move(args)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct BlockExpr final : Expr {
-    std::vector<StmtPtr> body;
+    std::pmr::vector<StmtPtr> body;
     Scope scope;
 
-    BlockExpr(const Location& loc, std::vector<StmtPtr> body)
-        : Expr(loc), body(std::move(body)), scope(Scope::Kind::Block) {
+    BlockExpr(const Location& loc, std::pmr::vector<StmtPtr> body, Arena& arena)
+        : Expr(NodeKind::Block, loc), body(std::move(body)), scope(Scope::Kind::Block, arena) {
     }
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 
@@ -124,11 +132,10 @@ struct IfElseExpr final : Expr {
     std::optional<ExprPtr> else_branch;
 
     IfElseExpr(const Location& loc, ExprPtr condition, ExprPtr if_branch, std::optional<ExprPtr> else_branch)
-        : Expr(loc), condition(std::move(condition)), if_branch(std::move(if_branch)),
+        : Expr(NodeKind::IfElse, loc), condition(std::move(condition)), if_branch(std::move(if_branch)),
         else_branch(std::move(else_branch)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 
@@ -137,60 +144,64 @@ struct WhileExpr final : Expr {
     ExprPtr body;
 
     WhileExpr(const Location& loc, ExprPtr condition, ExprPtr body)
-        : Expr(loc), condition(std::move(condition)), body(std::move(body)) {}
+        : Expr(NodeKind::While, loc), condition(std::move(condition)), body(std::move(body)) {}
 
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 
+static int parse_int(const std::string_view lexeme) {
+    int val = 0;
+    const auto [_, ec] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), val);
+    if (ec != std::errc()) {
+        throw std::out_of_range("Invalid int constant");
+    }
+    return val;
+}
+
 struct IntConst final : Expr {
     int val;
 
     explicit IntConst(const Token& tok)
-        : Expr(tok.loc), val(std::stoi(tok.lexeme)) {}
+        : Expr(NodeKind::IntConst, tok.loc), val(parse_int(tok.lexeme)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct FloatConst final: Expr {
     double val;
 
     explicit FloatConst(const Token& tok)
-        : Expr(tok.loc), val(std::stod(tok.lexeme)) {}
+        : Expr(NodeKind::FloatConst, tok.loc), val(std::stod(std::string(tok.lexeme))) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct CharConst final: Expr {
     char val;
 
     explicit CharConst(const Token& tok)
-        : Expr(tok.loc), val(tok.lexeme[0]) {}
+        : Expr(NodeKind::CharConst, tok.loc), val(tok.lexeme[0]) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct StringConst final: Expr {
-    std::string val;
+    std::string_view val;
 
-    explicit StringConst(const Token& tok)
-        : Expr(tok.loc), val(tok.lexeme) {}
+    // Escaped literals don't live in the source buffer, so the value is copied into the arena
+    StringConst(const Token& tok, Arena& arena)
+        : Expr(NodeKind::StringConst, tok.loc), val(arena.copy(tok.lexeme)) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct BoolConst final : Expr {
     bool val;
 
     explicit BoolConst(const Token& tok)
-        : Expr(tok.loc), val(tok.type == TokenType::True) {}
+        : Expr(NodeKind::BoolConst, tok.loc), val(tok.type == TokenType::True) {}
 
     void accept(Visitor &visitor) override;
-    llvm::Value* codegen_accept(CodegenVisitor& visitor) override;
 };
\ No newline at end of file
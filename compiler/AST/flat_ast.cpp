@@ -0,0 +1,251 @@
+#include "flat_ast.h"
+
+#include <bit>
+
+#include "stmt_nodes.h"
+#include "visitor.h"
+
+NodeId FlatAst::child(const NodeId id) const {
+    return payloads[id];
+}
+
+Ident FlatAst::ident(const NodeId id) const {
+    return {payloads[id]};
+}
+
+int FlatAst::int_val(const NodeId id) const {
+    return std::bit_cast<int>(payloads[id]);
+}
+
+char FlatAst::char_val(const NodeId id) const {
+    return static_cast<char>(payloads[id]);
+}
+
+bool FlatAst::bool_val(const NodeId id) const {
+    return payloads[id] != 0;
+}
+
+double FlatAst::float_val(const NodeId id) const {
+    return floats[payloads[id]];
+}
+
+std::string_view FlatAst::str(const NodeId id) const {
+    return strings[payloads[id]];
+}
+
+std::span<const NodeId> FlatAst::args(const NodeId id) const {
+    const auto& c = call(id);
+    return std::span(lists).subspan(c.first_arg, c.arg_count);
+}
+
+std::span<const NodeId> FlatAst::body(const NodeId id) const {
+    const auto& b = block(id);
+    return std::span(lists).subspan(b.first_stmt, b.stmt_count);
+}
+
+std::span<const FlatAst::Param> FlatAst::fun_params(const NodeId id) const {
+    const auto& f = fun(id);
+    return std::span(params).subspan(f.first_param, f.param_count);
+}
+
+template<typename... T>
+static void shrink(std::vector<T>&... v) {
+    (v.shrink_to_fit(), ...);
+}
+
+void FlatAst::shrink_to_fit() {
+    shrink(kinds, payloads, locs, scopes, types, syms, unaries, binaries, calls, blocks, if_elses, whiles, vars,
+           assigns, funs, params, floats, strings, lists, roots);
+}
+
+template<typename T>
+static size_t bytes_of(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+size_t FlatAst::bytes() const {
+    return bytes_of(kinds) + bytes_of(payloads) + bytes_of(locs) + bytes_of(scopes) + bytes_of(types) + bytes_of(syms)
+        + bytes_of(unaries) + bytes_of(binaries) + bytes_of(calls) + bytes_of(blocks) + bytes_of(if_elses)
+        + bytes_of(whiles) + bytes_of(vars) + bytes_of(assigns) + bytes_of(funs) + bytes_of(params)
+        + bytes_of(floats) + bytes_of(strings) + bytes_of(lists) + bytes_of(roots);
+}
+
+// Emits the children of a node before the node itself. `last` is the id of the node
+// emitted by the most recent accept call.
+struct FlatBuilder final : Visitor {
+    FlatAst& out;
+    NodeId last = no_node;
+
+    explicit FlatBuilder(FlatAst& out) : out(out) {}
+
+    template<typename T>
+    static uint32_t push(std::vector<T>& v, T val) {
+        v.push_back(std::move(val));
+        return static_cast<uint32_t>(v.size() - 1);
+    }
+
+    void emit(const NodeKind kind, const uint32_t payload, const Location& loc, Scope* scope, Type* type,
+              Symbol* sym) {
+        last = static_cast<NodeId>(out.kinds.size());
+        out.kinds.push_back(kind);
+        out.payloads.push_back(payload);
+        out.locs.push_back(loc);
+        out.scopes.push_back(scope);
+        out.types.push_back(type);
+        out.syms.push_back(sym);
+    }
+
+    void emit(const NodeKind kind, const uint32_t payload, const Expr& expr, Symbol* sym = nullptr) {
+        emit(kind, payload, expr.loc, expr.parent_scope, expr.type, sym);
+    }
+
+    void emit(const NodeKind kind, const uint32_t payload, const Stmt& stmt, Symbol* sym = nullptr) {
+        emit(kind, payload, stmt.loc, stmt.parent_scope, stmt.type, sym);
+    }
+
+    template<typename T>
+    NodeId flatten(const NodePtr<T>& node) {
+        node->accept(*this);
+        return last;
+    }
+
+    // The ids are collected first because nested lists are emitted in between
+    template<typename Range>
+    uint32_t flatten_list(const Range& nodes) {
+        std::vector<NodeId> ids;
+        ids.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            ids.push_back(flatten(node));
+        }
+        const auto first = static_cast<uint32_t>(out.lists.size());
+        out.lists.insert(out.lists.end(), ids.begin(), ids.end());
+        return first;
+    }
+
+    uint32_t flatten_params(const FunSignature& sig) {
+        const auto first = static_cast<uint32_t>(out.params.size());
+        for (const auto& arg : sig.args) {
+            out.params.push_back({arg.id, arg.anno.kind, arg.sym});
+        }
+        return first;
+    }
+
+    void visit(ParenExpr& expr) override {
+        const NodeId inner = flatten(expr.expr);
+        emit(NodeKind::Paren, inner, expr);
+    }
+
+    void visit(UnaryExpr& expr) override {
+        const NodeId operand = flatten(expr.operand);
+        emit(NodeKind::Unary, push(out.unaries, {expr.op, operand}), expr);
+    }
+
+    void visit(BinaryExpr& expr) override {
+        const NodeId lhs = flatten(expr.lhs);
+        const NodeId rhs = flatten(expr.rhs);
+        emit(NodeKind::Binary, push(out.binaries, {expr.op, lhs, rhs}), expr);
+    }
+
+    void visit(IdExpr& expr) override {
+        emit(NodeKind::Id, expr.id.id, expr, expr.sym);
+    }
+
+    void visit(FunCall& expr) override {
+        const uint32_t first = flatten_list(expr.args);
+        const auto count = static_cast<uint32_t>(expr.args.size());
+        emit(NodeKind::FunCall, push(out.calls, {expr.qualifier, expr.callee, first, count}), expr, expr.sym);
+    }
+
+    void visit(BlockExpr& expr) override {
+        const uint32_t first = flatten_list(expr.body);
+        const auto count = static_cast<uint32_t>(expr.body.size());
+        emit(NodeKind::Block, push(out.blocks, {&expr.scope, first, count}), expr);
+    }
+
+    void visit(IfElseExpr& expr) override {
+        FlatAst::IfElse node{flatten(expr.condition), flatten(expr.if_branch)};
+        if (expr.else_branch.has_value()) {
+            node.else_branch = flatten(expr.else_branch.value());
+        }
+        emit(NodeKind::IfElse, push(out.if_elses, node), expr);
+    }
+
+    void visit(WhileExpr& expr) override {
+        const NodeId condition = flatten(expr.condition);
+        const NodeId body = flatten(expr.body);
+        emit(NodeKind::While, push(out.whiles, {condition, body}), expr);
+    }
+
+    void visit(IntConst& expr) override {
+        emit(NodeKind::IntConst, std::bit_cast<uint32_t>(expr.val), expr);
+    }
+
+    void visit(FloatConst& expr) override {
+        emit(NodeKind::FloatConst, push(out.floats, expr.val), expr);
+    }
+
+    void visit(CharConst& expr) override {
+        emit(NodeKind::CharConst, static_cast<unsigned char>(expr.val), expr);
+    }
+
+    void visit(StringConst& expr) override {
+        emit(NodeKind::StringConst, push(out.strings, expr.val), expr);
+    }
+
+    void visit(BoolConst& expr) override {
+        emit(NodeKind::BoolConst, expr.val, expr);
+    }
+
+    void visit(ExprStmt& stmt) override {
+        const NodeId expr = flatten(stmt.expr);
+        emit(NodeKind::ExprStmt, expr, stmt);
+    }
+
+    void visit(VarInit& stmt) override {
+        const NodeId val = flatten(stmt.val);
+        std::optional<TypeAnno::Kind> anno;
+        if (stmt.anno.has_value()) {
+            anno = stmt.anno->kind;
+        }
+        emit(NodeKind::VarInit, push(out.vars, {stmt.id, val, anno, stmt.is_internal, stmt.is_const}), stmt, stmt.sym);
+    }
+
+    void visit(Assignment& stmt) override {
+        const NodeId val = flatten(stmt.val);
+        emit(NodeKind::Assignment, push(out.assigns, {stmt.assignee, val}), stmt, stmt.sym);
+    }
+
+    void visit(FunDef& def) override {
+        const NodeId body = flatten(def.body);
+        const auto& sig = def.signature;
+        const FlatAst::Fun fun{sig.id, &def.scope, body, flatten_params(sig),
+            static_cast<uint32_t>(sig.args.size()), sig.anno.kind, sig.var_arg, def.is_internal};
+        emit(NodeKind::FunDef, push(out.funs, fun), def.loc, def.parent_scope, sig.type, sig.sym);
+    }
+
+    void visit(ExternalStmt& stmt) override {
+        const auto& sig = stmt.signature;
+        const FlatAst::Fun fun{sig.id, nullptr, no_node, flatten_params(sig),
+            static_cast<uint32_t>(sig.args.size()), sig.anno.kind, sig.var_arg, false};
+        emit(NodeKind::External, push(out.funs, fun), stmt.loc, stmt.parent_scope, sig.type, sig.sym);
+    }
+
+    void visit(ImportStmt& stmt) override {
+        emit(NodeKind::Import, stmt.name.id, stmt);
+    }
+
+    // Signatures, parameters and annotations are stored inline in the nodes that own them
+    void visit(TypeAnno&) override {}
+    void visit(DefArg&) override {}
+    void visit(FunSignature&) override {}
+};
+
+FlatAst flatten(const std::vector<StmtPtr>& ast) {
+    FlatAst flat;
+    FlatBuilder builder(flat);
+    for (const auto& node : ast) {
+        flat.roots.push_back(builder.flatten(node));
+    }
+    flat.shrink_to_fit();
+    return flat;
+}
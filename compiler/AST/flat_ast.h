@@ -0,0 +1,156 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "expr_nodes.h"
+#include "interner.h"
+#include "location.h"
+#include "node_kind.h"
+#include "stmt.h"
+#include "type_anno.h"
+
+using NodeId = uint32_t;
+constexpr NodeId no_node = std::numeric_limits<NodeId>::max();
+
+// Index based encoding of an AST. Nodes are numbered in post-order, so the children of a node
+// always have smaller ids and a pass that needs its operands first can walk ids 0..size()
+// front to back. Everything else about a node lives in arrays indexed by its id, the data
+// specific to a kind in a contiguous array of that kind.
+struct FlatAst {
+    struct Unary {
+        UnaryOp op;
+        NodeId operand;
+    };
+
+    struct Binary {
+        BinaryOp op;
+        NodeId lhs;
+        NodeId rhs;
+    };
+
+    // The arguments are lists[first_arg, first_arg + arg_count)
+    struct Call {
+        Ident qualifier;
+        Ident callee;
+        uint32_t first_arg;
+        uint32_t arg_count;
+    };
+
+    // The statements are lists[first_stmt, first_stmt + stmt_count)
+    struct Block {
+        Scope* scope;
+        uint32_t first_stmt;
+        uint32_t stmt_count;
+    };
+
+    struct IfElse {
+        NodeId condition;
+        NodeId if_branch;
+        NodeId else_branch = no_node;
+    };
+
+    struct While {
+        NodeId condition;
+        NodeId body;
+    };
+
+    struct Var {
+        Ident id;
+        NodeId val;
+        std::optional<TypeAnno::Kind> anno;
+        bool is_internal;
+        bool is_const;
+    };
+
+    struct Assign {
+        Ident assignee;
+        NodeId val;
+    };
+
+    struct Param {
+        Ident id;
+        TypeAnno::Kind anno;
+        Symbol* sym;
+    };
+
+    // Shared by function definitions and external declarations, which have no body and no scope
+    struct Fun {
+        Ident id;
+        Scope* scope;
+        NodeId body;
+        uint32_t first_param;
+        uint32_t param_count;
+        TypeAnno::Kind anno;
+        bool var_arg;
+        bool is_internal;
+    };
+
+    std::vector<NodeKind> kinds;
+    // The child of Paren and ExprStmt nodes, the identifier of Id and Import nodes, the value of Int, Char
+    // and Bool constants, otherwise the index into the array of the node's kind
+    std::vector<uint32_t> payloads;
+
+    // Side tables
+    std::vector<Location> locs;
+    std::vector<Scope*> scopes;
+    std::vector<Type*> types;
+    // The symbol an Id, FunCall or Assignment refers to, or the one a VarInit, FunDef or External defines
+    std::vector<Symbol*> syms;
+
+    std::vector<Unary> unaries;
+    std::vector<Binary> binaries;
+    std::vector<Call> calls;
+    std::vector<Block> blocks;
+    std::vector<IfElse> if_elses;
+    std::vector<While> whiles;
+    std::vector<Var> vars;
+    std::vector<Assign> assigns;
+    std::vector<Fun> funs;
+    std::vector<Param> params;
+    std::vector<double> floats;
+    std::vector<std::string_view> strings;
+    // Call arguments and block bodies
+    std::vector<NodeId> lists;
+
+    // The top level statements in source order
+    std::vector<NodeId> roots;
+
+    size_t size() const { return kinds.size(); }
+    NodeKind kind(const NodeId id) const { return kinds[id]; }
+
+    NodeId child(NodeId id) const;
+    Ident ident(NodeId id) const;
+    int int_val(NodeId id) const;
+    char char_val(NodeId id) const;
+    bool bool_val(NodeId id) const;
+    double float_val(NodeId id) const;
+    // The value of a StringConst
+    std::string_view str(NodeId id) const;
+
+    const Unary& unary(const NodeId id) const { return unaries[payloads[id]]; }
+    const Binary& binary(const NodeId id) const { return binaries[payloads[id]]; }
+    const Call& call(const NodeId id) const { return calls[payloads[id]]; }
+    const Block& block(const NodeId id) const { return blocks[payloads[id]]; }
+    const IfElse& if_else(const NodeId id) const { return if_elses[payloads[id]]; }
+    const While& while_loop(const NodeId id) const { return whiles[payloads[id]]; }
+    const Var& var(const NodeId id) const { return vars[payloads[id]]; }
+    const Assign& assign(const NodeId id) const { return assigns[payloads[id]]; }
+    const Fun& fun(const NodeId id) const { return funs[payloads[id]]; }
+
+    std::span<const NodeId> args(NodeId id) const;
+    std::span<const NodeId> body(NodeId id) const;
+    std::span<const Param> fun_params(NodeId id) const;
+
+    // Releases the spare capacity of all arrays
+    void shrink_to_fit();
+
+    // Heap memory held by all arrays
+    size_t bytes() const;
+};
+
+// Locations, scopes, types and symbols are copied as well, so flattening after a pass keeps its results
+FlatAst flatten(const std::vector<StmtPtr>& ast);
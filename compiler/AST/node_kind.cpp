@@ -0,0 +1,27 @@
+#include "node_kind.h"
+
+std::string_view str_of_node_kind(const NodeKind kind) {
+    using enum NodeKind;
+    switch (kind) {
+        case Paren: return "Paren";
+        case Unary: return "Unary";
+        case Binary: return "Binary";
+        case Id: return "Id";
+        case FunCall: return "FunCall";
+        case Block: return "Block";
+        case IfElse: return "IfElse";
+        case While: return "While";
+        case IntConst: return "IntConst";
+        case FloatConst: return "FloatConst";
+        case CharConst: return "CharConst";
+        case StringConst: return "StringConst";
+        case BoolConst: return "BoolConst";
+        case ExprStmt: return "ExprStmt";
+        case VarInit: return "VarInit";
+        case Assignment: return "Assignment";
+        case FunDef: return "FunDef";
+        case External: return "External";
+        case Import: return "Import";
+    }
+    return "";
+}
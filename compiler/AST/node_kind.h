@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+enum class NodeKind : uint8_t {
+    // Expressions
+    Paren, Unary, Binary, Id, FunCall, Block, IfElse, While,
+    IntConst, FloatConst, CharConst, StringConst, BoolConst,
+    // Statements
+    ExprStmt, VarInit, Assignment, FunDef, External, Import,
+};
+
+constexpr int node_kind_count = static_cast<int>(NodeKind::Import) + 1;
+
+std::string_view str_of_node_kind(NodeKind kind);
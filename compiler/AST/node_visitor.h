@@ -0,0 +1,60 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+
+#include "expr_nodes.h"
+#include "stmt_nodes.h"
+
+// Dispatches on the kind stored in every node with a switch instead of a virtual accept followed
+// by a virtual visit. Derived implements visit for the nodes it handles, the others go to the
+// fallbacks below, which Derived has to bring into scope with `using NodeVisitor::visit;`.
+template<typename Derived, typename ExprResult = void, typename StmtResult = void>
+struct NodeVisitor {
+    ExprResult dispatch(Expr& expr) {
+        switch (expr.kind) {
+            case NodeKind::Paren: return call<ExprResult>(static_cast<ParenExpr&>(expr));
+            case NodeKind::Unary: return call<ExprResult>(static_cast<UnaryExpr&>(expr));
+            case NodeKind::Binary: return call<ExprResult>(static_cast<BinaryExpr&>(expr));
+            case NodeKind::Id: return call<ExprResult>(static_cast<IdExpr&>(expr));
+            case NodeKind::FunCall: return call<ExprResult>(static_cast<FunCall&>(expr));
+            case NodeKind::Block: return call<ExprResult>(static_cast<BlockExpr&>(expr));
+            case NodeKind::IfElse: return call<ExprResult>(static_cast<IfElseExpr&>(expr));
+            case NodeKind::While: return call<ExprResult>(static_cast<WhileExpr&>(expr));
+            case NodeKind::IntConst: return call<ExprResult>(static_cast<IntConst&>(expr));
+            case NodeKind::FloatConst: return call<ExprResult>(static_cast<FloatConst&>(expr));
+            case NodeKind::CharConst: return call<ExprResult>(static_cast<CharConst&>(expr));
+            case NodeKind::StringConst: return call<ExprResult>(static_cast<StringConst&>(expr));
+            case NodeKind::BoolConst: return call<ExprResult>(static_cast<BoolConst&>(expr));
+            default: break;
+        }
+        std::unreachable();
+    }
+
+    StmtResult dispatch(Stmt& stmt) {
+        switch (stmt.kind) {
+            case NodeKind::ExprStmt: return call<StmtResult>(static_cast<ExprStmt&>(stmt));
+            case NodeKind::VarInit: return call<StmtResult>(static_cast<VarInit&>(stmt));
+            case NodeKind::Assignment: return call<StmtResult>(static_cast<Assignment&>(stmt));
+            case NodeKind::FunDef: return call<StmtResult>(static_cast<FunDef&>(stmt));
+            case NodeKind::External: return call<StmtResult>(static_cast<ExternalStmt&>(stmt));
+            case NodeKind::Import: return call<StmtResult>(static_cast<ImportStmt&>(stmt));
+            default: break;
+        }
+        std::unreachable();
+    }
+
+    ExprResult visit(Expr&) { return ExprResult(); }
+    StmtResult visit(Stmt&) { return StmtResult(); }
+
+private:
+    // Lets visit return a value for a node even when the dispatch for its category doesn't
+    template<typename R, typename T>
+    R call(T& node) {
+        auto& self = static_cast<Derived&>(*this);
+        if constexpr (std::is_void_v<R>) {
+            self.visit(node);
+        } else {
+            return self.visit(node);
+        }
+    }
+};
@@ -63,7 +63,7 @@ void PrintVisitor::visit(BinaryExpr &expr)  {
 
 void PrintVisitor::visit(IdExpr &expr) {
     printIndent();
-    std::cout << "IdExpr: " + expr.id + "\n";
+    std::cout << "IdExpr: " << expr.id.str() << "\n";
 }
 
 void PrintVisitor::visit(IntConst &expr) {
@@ -93,7 +93,11 @@ void PrintVisitor::visit(BoolConst &expr) {
 
 void PrintVisitor::visit(FunCall &expr)  {
     printIndent();
-    std::cout << "FuncCall: " << expr.callee << "\n";
+    std::cout << "FuncCall: ";
+    if (expr.qualifier.id) {
+        std::cout << expr.qualifier.str() << ".";
+    }
+    std::cout << expr.callee.str() << "\n";
     indent++;
     for (const auto& arg : expr.args) {
         arg->accept(*this);
@@ -147,7 +151,7 @@ void PrintVisitor::visit(ExprStmt &stmt)  {
 
 void PrintVisitor::visit(VarInit &stmt)  {
     printIndent();
-    std::cout << (stmt.is_const ? "let" : "var") << ": " + stmt.id << "\n";
+    std::cout << (stmt.is_const ? "let" : "var") << ": " << stmt.id.str() << "\n";
     indent++;
     if (stmt.anno.has_value()) {
         stmt.anno->accept(*this);
@@ -165,7 +169,7 @@ void PrintVisitor::visit(Assignment &stmt)  {
     std::cout << "Assignment:\n";
     indent++;
     printIndent();
-    std::cout << stmt.assignee << "\n";
+    std::cout << stmt.assignee.str() << "\n";
     indent--;
     printIndent();
     std::cout << "=\n";
@@ -181,12 +185,17 @@ void PrintVisitor::visit(ExternalStmt &stmt) {
     std::cout << "\n";
 }
 
+void PrintVisitor::visit(ImportStmt &stmt) {
+    printIndent();
+    std::cout << "ImportStmt: " << stmt.name.str() << "\n";
+}
+
 
 
 
 void PrintVisitor::visit(DefArg &arg)  {
     printIndent();
-    std::cout << "Arg: " + arg.id << "\n";
+    std::cout << "Arg: " << arg.id.str() << "\n";
     indent++;
     arg.anno.accept(*this);
     indent--;
@@ -195,7 +204,7 @@ void PrintVisitor::visit(DefArg &arg)  {
 
 void PrintVisitor::visit(FunSignature &header) {
     printIndent();
-    std::cout << "fun: " << header.id << "\n";
+    std::cout << "fun: " << header.id.str() << "\n";
     indent++;
     for (auto& arg: header.args) {
         arg.accept(*this);
@@ -58,4 +58,6 @@ struct PrintVisitor final : Visitor {
     void visit(FunDef &def) override;
 
     void visit(ExternalStmt& stmt) override;
+
+    void visit(ImportStmt& stmt) override;
 };
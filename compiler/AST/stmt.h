@@ -1,10 +1,10 @@
 #pragma once
-#include <memory>
+#include "arena.h"
 
 #include "location.h"
+#include "node_kind.h"
 
 
-struct CodegenVisitor;
 struct Type;
 struct Visitor;
 struct Scope;
@@ -12,17 +12,18 @@ struct Scope;
 struct Stmt {
     virtual ~Stmt() = default;
 
+    // Lets NodeVisitor dispatch without virtual calls
+    NodeKind kind;
     Location loc;
     Scope* parent_scope = nullptr;
     Type* type = nullptr;
 
-    explicit Stmt(const Location &loc): loc(loc) {}
+    Stmt(const NodeKind kind, const Location &loc): kind(kind), loc(loc) {}
 
     virtual void accept(Visitor&) = 0;
-    virtual void codegen_accept(CodegenVisitor& visitor) = 0;
 };
 
-using StmtPtr = std::unique_ptr<Stmt>;
+using StmtPtr = NodePtr<Stmt>;
 
 struct VarInit;
 struct Assignment;
@@ -30,4 +31,5 @@ struct ExprStmt;
 struct DefArg;
 struct FunSignature;
 struct FunDef;
-struct ExternalStmt;
\ No newline at end of file
+struct ExternalStmt;
+struct ImportStmt;
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory_resource>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -12,52 +13,54 @@
 struct VarInit final : Stmt {
     bool is_internal;
     bool is_const;
-    std::string id;
+    Ident id;
     std::optional<TypeAnno> anno;
     ExprPtr val;
+    // The symbol this defines, set by name resolution
+    Symbol* sym = nullptr;
 
     VarInit(const Location& loc,
         bool is_internal, bool is_const,
-        std::string id, const std::optional<TypeAnno>& type_anno, ExprPtr val)
-        : Stmt(loc),
+        Ident id, const std::optional<TypeAnno>& type_anno, ExprPtr val)
+        : Stmt(NodeKind::VarInit, loc),
         is_internal(is_internal), is_const(is_const),
-        id(std::move(id)), anno(type_anno), val(std::move(val)) {}
+        id(id), anno(type_anno), val(std::move(val)) {}
 
     void accept(Visitor &visitor) override;
-    void codegen_accept(CodegenVisitor& visitor) override;
 
 };
 
 struct Assignment final : Stmt {
-    std::string assignee;
+    Ident assignee;
     ExprPtr val;
+    // Set by name resolution
+    Symbol* sym = nullptr;
 
     Assignment(Token& assignee, ExprPtr val)
-        : Stmt(assignee.loc), assignee(std::move(assignee.lexeme)), val(std::move(val)) {}
+        : Stmt(NodeKind::Assignment, assignee.loc), assignee(assignee.ident), val(std::move(val)) {}
 
     void accept(Visitor &visitor) override;
-    void codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct ExprStmt final : Stmt {
     ExprPtr expr;
 
     explicit ExprStmt(const Location& loc, ExprPtr expr)
-        : Stmt(loc), expr(std::move(expr)) {}
+        : Stmt(NodeKind::ExprStmt, loc), expr(std::move(expr)) {}
 
     void accept(Visitor &visitor) override;
-    void codegen_accept(CodegenVisitor& visitor) override;
 };
 
 
 struct DefArg {
     Location loc;
-    std::string id;
+    Ident id;
     TypeAnno anno;
     Scope* parent_scope = nullptr;
+    Symbol* sym = nullptr;
 
     DefArg(const Token& id, const TypeAnno& anno)
-        : loc(id.loc), id(id.lexeme), anno(anno) {}
+        : loc(id.loc), id(id.ident), anno(anno) {}
 
     void accept(Visitor &visitor);
 };
@@ -65,10 +68,12 @@ struct DefArg {
 struct FunSignature {
     Location loc;
     bool var_arg = false;
-    std::string id;
-    std::vector<DefArg> args;
+    Ident id;
+    std::pmr::vector<DefArg> args;
     TypeAnno anno;
     Scope* parent_scope = nullptr;
+    // Set by the module collector for functions at the module level, otherwise by name resolution
+    Symbol* sym = nullptr;
     Type* type;
 
     void accept(Visitor &visitor);
@@ -80,21 +85,31 @@ struct FunDef final : Stmt {
     ExprPtr body;
     Scope scope;
 
-    FunDef(const Location& loc, bool is_internal, FunSignature sig, ExprPtr body)
-        : Stmt(loc), is_internal(is_internal),
+    FunDef(const Location& loc, bool is_internal, FunSignature sig, ExprPtr body, Arena& arena)
+        : Stmt(NodeKind::FunDef, loc), is_internal(is_internal),
           signature(std::move(sig)), body(std::move(body)),
-            scope(Scope::Kind::Function){}
+            scope(Scope::Kind::Function, arena){}
 
     void accept(Visitor &visitor) override;
-    void codegen_accept(CodegenVisitor& visitor) override;
 };
 
 struct ExternalStmt final : Stmt {
     FunSignature signature;
 
     ExternalStmt(const Location& loc, FunSignature sig)
-        : Stmt(loc), signature(std::move(sig)) {}
+        : Stmt(NodeKind::External, loc), signature(std::move(sig)) {}
+
+    void accept(Visitor &visitor) override;
+};
+
+// import name, makes the module in name.arc next to the importing file available as name
+struct ImportStmt final : Stmt {
+    Ident name;
+    // Set by the driver once the imported module is loaded
+    Module* module = nullptr;
+
+    explicit ImportStmt(const Token& name)
+        : Stmt(NodeKind::Import, name.loc), name(name.ident) {}
 
     void accept(Visitor &visitor) override;
-    void codegen_accept(CodegenVisitor& visitor) override;
 };
\ No newline at end of file
@@ -50,6 +50,8 @@ struct Visitor {
     
     virtual void visit(ExternalStmt& stmt) = 0;
 
+    virtual void visit(ImportStmt& stmt) = 0;
+
     
     virtual ~Visitor() = default;
 };
@@ -1,8 +1,8 @@
 #pragma once
 #include <llvm/IR/IRBuilder.h>
-#include "stmt.h"
-#include "expr.h"
+#include "flat_ast.h"
 
+struct FunctionTy;
 struct TypeChecker;
 
 namespace llvm {
@@ -10,37 +10,52 @@ class LLVMContext;
 class Module;
 class Value;
     class Function;
-} 
+}
 
 
-struct CodegenVisitor {
+// Lowers the flat AST of a module. Types and symbols are read from its side tables, so the
+// pointer tree isn't touched once it has been type checked and flattened.
+struct CodegenVisitor final {
     llvm::LLVMContext& context;
     llvm::IRBuilder<>& builder;
     llvm::Module& module;
     Scope& module_scope;
     TypeChecker& type_checker;
+    const FlatAst& ast;
+
+    CodegenVisitor(llvm::LLVMContext& context, llvm::IRBuilder<>& builder, llvm::Module& module,
+                   Scope& module_scope, TypeChecker& type_checker, const FlatAst& ast)
+        : context(context), builder(builder), module(module), module_scope(module_scope),
+        type_checker(type_checker), ast(ast) {}
 
     llvm::Type* get_llvm_type(const Type* arco_ty) const;
 
-    llvm::Value* visit(const ParenExpr& expr);
-    llvm::Value* visit(const BlockExpr& expr);
-    llvm::Value* visit(const UnaryExpr& expr);
-    llvm::Value* visit(const BinaryExpr& expr);
-
-    llvm::Value* visit(const IdExpr& expr) const;
-    llvm::Value* visit(const IntConst& expr) const;
-    llvm::Value* visit(const FloatConst& expr) const;
-    llvm::Value* visit(const CharConst& expr) const;
-    llvm::Value* visit(const StringConst& expr) const;
-    llvm::Value* visit(const BoolConst& expr) const;
-    llvm::Value* visit(const FunCall& expr);
-    llvm::Value* visit(const IfElseExpr& expr);
-    llvm::Value* visit(const WhileExpr& expr);
-
-    llvm::Value* visit(const ExprStmt& stmt);
-    void visit(const VarInit& stmt);
-    void visit(const Assignment& stmt);
-    void visit(FunDef& def);
-    llvm::Function* get_llvm_signature(const FunSignature& sig) const;
-    void visit(const ExternalStmt& stmt) const;
-};
\ No newline at end of file
+    // The value of an expression, nullptr for statements and expressions of type unit
+    llvm::Value* dispatch(NodeId id);
+
+    llvm::Value* visit_block(NodeId id);
+    llvm::Value* visit_unary(NodeId id);
+    llvm::Value* visit_binary(NodeId id);
+
+    llvm::Value* visit_id(NodeId id) const;
+    llvm::Value* visit_int(NodeId id) const;
+    llvm::Value* visit_float(NodeId id) const;
+    llvm::Value* visit_char(NodeId id) const;
+    llvm::Value* visit_string(NodeId id) const;
+    llvm::Value* visit_bool(NodeId id) const;
+    llvm::Value* visit_call(NodeId id);
+    llvm::Value* visit_if_else(NodeId id);
+    llvm::Value* visit_while(NodeId id);
+
+    void visit_var(NodeId id);
+    void visit_assign(NodeId id);
+    void visit_fun(NodeId id);
+    llvm::Function* get_llvm_signature(const FunctionTy& type, const std::string& name) const;
+
+    // Internal functions are prefixed with the module name, so they can't clash with the
+    // functions of other modules once the modules are linked
+    std::string link_name(Ident id, bool is_internal) const;
+
+    // The declaration of a function in this module, created on first use
+    llvm::Function* declare(Ident id, const Type* type, bool is_internal) const;
+};
@@ -2,56 +2,72 @@
 #include "codegen_visitor.h"
 #include <llvm/IR/Module.h>
 
-#include "expr_nodes.h"
-#include "stmt_nodes.h"
+#include "symbol.h"
 #include "token_error.h"
 #include "type_checker.h"
 
-llvm::Value* CodegenVisitor::visit(const ParenExpr &expr) {
-    return expr.expr->codegen_accept(*this);
+llvm::Value* CodegenVisitor::dispatch(const NodeId id) {
+    switch (ast.kind(id)) {
+        case NodeKind::Paren:
+        case NodeKind::ExprStmt: return dispatch(ast.child(id));
+        case NodeKind::Unary: return visit_unary(id);
+        case NodeKind::Binary: return visit_binary(id);
+        case NodeKind::Id: return visit_id(id);
+        case NodeKind::FunCall: return visit_call(id);
+        case NodeKind::Block: return visit_block(id);
+        case NodeKind::IfElse: return visit_if_else(id);
+        case NodeKind::While: return visit_while(id);
+        case NodeKind::IntConst: return visit_int(id);
+        case NodeKind::FloatConst: return visit_float(id);
+        case NodeKind::CharConst: return visit_char(id);
+        case NodeKind::StringConst: return visit_string(id);
+        case NodeKind::BoolConst: return visit_bool(id);
+        case NodeKind::VarInit: visit_var(id); return nullptr;
+        case NodeKind::Assignment: visit_assign(id); return nullptr;
+        case NodeKind::FunDef: visit_fun(id); return nullptr;
+        case NodeKind::External: {
+            const auto& fun = ast.fun(id);
+            declare(fun.id, ast.types[id], false);
+            return nullptr;
+        }
+        // Imported functions are declared when they are first called
+        case NodeKind::Import: return nullptr;
+        default: break;
+    }
+    std::unreachable();
 }
 
-llvm::Value* CodegenVisitor::visit(const BlockExpr &expr) {
+// The value of the last statement is the value of the block
+llvm::Value* CodegenVisitor::visit_block(const NodeId id) {
     llvm::Value* val = nullptr;
-
-    for (size_t i = 0; i < expr.body.size(); ++i) {
-        auto& stmt = expr.body[i];
-
-        if (i == expr.body.size() - 1) {
-            if (const auto* e_s = dynamic_cast<ExprStmt*>(stmt.get())) {
-                // Codegen and capture the value
-                val = e_s->expr->codegen_accept(*this);
-            } else {
-                stmt->codegen_accept(*this);
-            }
-        } else {
-            // Middle statements -> just codegen, discard value
-            stmt->codegen_accept(*this);
-        }
+    for (const NodeId stmt : ast.body(id)) {
+        val = dispatch(stmt);
     }
-
     return val;
 }
 
-llvm::Value* CodegenVisitor::visit(const UnaryExpr &expr) {
-    auto* operand_val = expr.operand->codegen_accept(*this);
+llvm::Value* CodegenVisitor::visit_unary(const NodeId id) {
+    const auto& expr = ast.unary(id);
+    auto* operand_val = dispatch(expr.operand);
     using enum UnaryOp;
     switch (expr.op) {
         case Not: return builder.CreateNeg(operand_val, "neg_tmp_bool");
-        case Minus: if (expr.type == type_checker.int_ty()) {
+        case Minus: if (ast.types[id] == type_checker.int_ty()) {
             return builder.CreateNeg(operand_val, "neg_tmp_int");
         }
         return builder.CreateFNeg(operand_val, "neg_tmp_float");
         case Plus: return operand_val;
     }
-    throw TokenError("Codegen Error!", expr.loc);
+    throw TokenError("Codegen Error!", ast.locs[id]);
 }
 
-llvm::Value* CodegenVisitor::visit(const BinaryExpr &expr) {
-    llvm::Value* left = expr.lhs->codegen_accept(*this);
-    llvm::Value* right = expr.rhs->codegen_accept(*this);
+llvm::Value* CodegenVisitor::visit_binary(const NodeId id) {
+    const auto& expr = ast.binary(id);
+    const Type* type = ast.types[id];
+    llvm::Value* left = dispatch(expr.lhs);
+    llvm::Value* right = dispatch(expr.rhs);
     using enum BinaryOp;
-    if (expr.type == type_checker.int_ty()) {
+    if (type == type_checker.int_ty()) {
         switch (expr.op) {
             case Add: return builder.CreateAdd(left, right, "addtmp");
             case Sub: return builder.CreateSub(left, right, "subtmp");
@@ -60,7 +76,7 @@ llvm::Value* CodegenVisitor::visit(const BinaryExpr &expr) {
             case Mod: return builder.CreateSRem(left, right, "sremtmp");
             default: break;
         }
-    } else if (expr.type == type_checker.float_ty()) {
+    } else if (type == type_checker.float_ty()) {
         switch (expr.op) {
             case Add: return builder.CreateFAdd(left, right, "faddtmp");
             case Sub: return builder.CreateFSub(left, right, "fsubtmp");
@@ -68,7 +84,7 @@ llvm::Value* CodegenVisitor::visit(const BinaryExpr &expr) {
             case Div: return builder.CreateFDiv(left, right, "fdivtmp");
             default: break;
         }
-    } else if (expr.type == type_checker.bool_ty()) {
+    } else if (type == type_checker.bool_ty()) {
         switch (expr.op) {
             case And: return builder.CreateAnd(left, right, "andtmp");
             case Or: return builder.CreateOr(left, right, "ortmp");
@@ -76,8 +92,10 @@ llvm::Value* CodegenVisitor::visit(const BinaryExpr &expr) {
         }
     }
 
-    if (expr.type == type_checker.bool_ty()) {
-        if (expr.lhs->type == type_checker.int_ty() && expr.rhs->type == type_checker.int_ty()) {
+    if (type == type_checker.bool_ty()) {
+        const Type* lhs_type = ast.types[expr.lhs];
+        const Type* rhs_type = ast.types[expr.rhs];
+        if (lhs_type == type_checker.int_ty() && rhs_type == type_checker.int_ty()) {
             switch (expr.op) {
                 case Equals: return builder.CreateICmpEQ(left, right, "eqtmp");
                 case NotEquals: return builder.CreateICmpNE(left, right, "netmp");
@@ -87,7 +105,7 @@ llvm::Value* CodegenVisitor::visit(const BinaryExpr &expr) {
                 case LessEquals: return builder.CreateICmpSLE(left, right, "sletmp");
                 default: break;
             }
-        } else if (expr.lhs->type == type_checker.float_ty() && expr.rhs->type == type_checker.float_ty()) {
+        } else if (lhs_type == type_checker.float_ty() && rhs_type == type_checker.float_ty()) {
             switch (expr.op) {
                 case Equals: return builder.CreateFCmpOEQ(left, right, "feqtmp");
                 case NotEquals: return builder.CreateFCmpONE(left, right, "fnetmp");
@@ -99,51 +117,55 @@ llvm::Value* CodegenVisitor::visit(const BinaryExpr &expr) {
             }
         }
     }
-    throw TokenError("Invalid expression type", expr.loc);
+    throw TokenError("Invalid expression type", ast.locs[id]);
 }
 
-llvm::Value* CodegenVisitor::visit(const IdExpr &expr) const {
-    llvm::AllocaInst* a = expr.parent_scope->get_symbol(expr.id).val;
-
-    return builder.CreateLoad(a->getAllocatedType(), a, expr.id.c_str());
+llvm::Value* CodegenVisitor::visit_id(const NodeId id) const {
+    const Symbol& sym = *ast.syms[id];
+    if (!sym.is_reassigned) {
+        return sym.val;
+    }
+    const auto* a = llvm::cast<llvm::AllocaInst>(sym.val);
+    return builder.CreateLoad(a->getAllocatedType(), sym.val, ast.ident(id).str());
 }
 
-llvm::Value* CodegenVisitor::visit(const IntConst& expr) const {
-    return llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), expr.val, true);
+llvm::Value* CodegenVisitor::visit_int(const NodeId id) const {
+    return llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), ast.int_val(id), true);
 }
 
-llvm::Value* CodegenVisitor::visit(const FloatConst& expr) const {
-    return llvm::ConstantFP::get(context, llvm::APFloat(expr.val));
+llvm::Value* CodegenVisitor::visit_float(const NodeId id) const {
+    return llvm::ConstantFP::get(context, llvm::APFloat(ast.float_val(id)));
 }
 
-llvm::Value* CodegenVisitor::visit(const CharConst &expr) const {
-    return llvm::ConstantInt::get(llvm::Type::getInt8Ty(context), expr.val, true);
+llvm::Value* CodegenVisitor::visit_char(const NodeId id) const {
+    return llvm::ConstantInt::get(llvm::Type::getInt8Ty(context), ast.char_val(id), true);
 }
 
-llvm::Value* CodegenVisitor::visit(const StringConst& expr) const {
-    llvm::Value* str_ptr = builder.CreateGlobalString(expr.val, "str");
+llvm::Value* CodegenVisitor::visit_string(const NodeId id) const {
+    llvm::Value* str_ptr = builder.CreateGlobalString(ast.str(id), "str");
 
     return str_ptr;
 }
 
-llvm::Value* CodegenVisitor::visit(const BoolConst& expr) const {
-    return llvm::ConstantInt::get(llvm::Type::getInt1Ty(context), expr.val, false);
+llvm::Value* CodegenVisitor::visit_bool(const NodeId id) const {
+    return llvm::ConstantInt::get(llvm::Type::getInt1Ty(context), ast.bool_val(id), false);
 }
 
-llvm::Value* CodegenVisitor::visit(const FunCall &expr) {
-    llvm::Function* callee = module.getFunction(expr.callee);
-    if (!callee) {
-        callee = get_llvm_signature(std::get<FunSymbol>(expr.parent_scope->get_symbol(expr.callee).kind).signature);
+llvm::Value* CodegenVisitor::visit_call(const NodeId id) {
+    llvm::Function* callee = module.getFunction("printf");
+    if (const Symbol* sym = ast.syms[id]) {
+        callee = declare(ast.call(id).callee, sym->type, std::get<FunSymbol>(sym->kind).is_internal);
     }
     std::vector<llvm::Value*> args;
-    for (const auto& arg : expr.args) {
-        args.push_back(arg->codegen_accept(*this));
+    for (const NodeId arg : ast.args(id)) {
+        args.push_back(dispatch(arg));
     }
     return builder.CreateCall(callee, args, "call_tmp");
 }
 
-llvm::Value* CodegenVisitor::visit(const IfElseExpr &expr) {
-    auto cond_value = expr.condition->codegen_accept(*this);
+llvm::Value* CodegenVisitor::visit_if_else(const NodeId id) {
+    const auto& expr = ast.if_else(id);
+    auto cond_value = dispatch(expr.condition);
 
     cond_value = builder.CreateICmpNE(cond_value,
         llvm::ConstantInt::get(cond_value->getType(), 0), "ifcond");
@@ -154,7 +176,7 @@ llvm::Value* CodegenVisitor::visit(const IfElseExpr &expr) {
     llvm::BasicBlock *merge_BB = llvm::BasicBlock::Create(context, "ifcont");
 
     llvm::BasicBlock *else_BB = nullptr;
-    if (expr.else_branch.has_value()) {
+    if (expr.else_branch != no_node) {
         else_BB = llvm::BasicBlock::Create(context, "else", function);
         builder.CreateCondBr(cond_value, then_BB, else_BB);
     } else {
@@ -163,7 +185,7 @@ llvm::Value* CodegenVisitor::visit(const IfElseExpr &expr) {
 
     // then branch
     builder.SetInsertPoint(then_BB);
-    llvm::Value* then_v = expr.if_branch->codegen_accept(*this);
+    llvm::Value* then_v = dispatch(expr.if_branch);
     builder.CreateBr(merge_BB);
     then_BB = builder.GetInsertBlock();
 
@@ -171,7 +193,7 @@ llvm::Value* CodegenVisitor::visit(const IfElseExpr &expr) {
     llvm::Value* else_v = nullptr;
     if (else_BB) {
         builder.SetInsertPoint(else_BB);
-        else_v = expr.else_branch.value()->codegen_accept(*this);
+        else_v = dispatch(expr.else_branch);
         builder.CreateBr(merge_BB);
         else_BB = builder.GetInsertBlock();
     }
@@ -187,7 +209,8 @@ llvm::Value* CodegenVisitor::visit(const IfElseExpr &expr) {
     return pn;
 }
 
-llvm::Value* CodegenVisitor::visit(const WhileExpr &expr) {
+llvm::Value* CodegenVisitor::visit_while(const NodeId id) {
+    const auto& expr = ast.while_loop(id);
     llvm::Function* function = builder.GetInsertBlock()->getParent();
 
     llvm::BasicBlock* cond_BB = llvm::BasicBlock::Create(context, "while.cond", function);
@@ -201,7 +224,7 @@ llvm::Value* CodegenVisitor::visit(const WhileExpr &expr) {
 
     builder.SetInsertPoint(cond_BB);
 
-    llvm::Value* cond_value = expr.condition->codegen_accept(*this);
+    llvm::Value* cond_value = dispatch(expr.condition);
 
     cond_value = builder.CreateICmpNE(
         cond_value,
@@ -214,7 +237,7 @@ llvm::Value* CodegenVisitor::visit(const WhileExpr &expr) {
 
     builder.SetInsertPoint(body_BB);
 
-    expr.body->codegen_accept(*this);
+    dispatch(expr.body);
 
     if (!builder.GetInsertBlock()->getTerminator()) {
         builder.CreateBr(cond_BB);
@@ -227,7 +250,3 @@ llvm::Value* CodegenVisitor::visit(const WhileExpr &expr) {
     // While loop produces no value
     return nullptr;
 }
-
-llvm::Value* CodegenVisitor::visit(const ExprStmt& stmt) {
-    return stmt.expr->codegen_accept(*this);
-}
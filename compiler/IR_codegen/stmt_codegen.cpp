@@ -2,7 +2,7 @@
 #include <llvm/IR/Verifier.h>
 
 #include "codegen_visitor.h"
-#include "stmt_nodes.h"
+#include "symbol.h"
 #include "token_error.h"
 #include "type_checker.h"
 
@@ -23,87 +23,113 @@ llvm::Type* CodegenVisitor::get_llvm_type(const Type* arco_ty) const {
     throw std::runtime_error("Invalid type");
 }
 
-void CodegenVisitor::visit(FunDef &def) {
-    auto* f = module.getFunction(def.signature.id);
-    if (!f) {
-        f = get_llvm_signature(def.signature);
+void CodegenVisitor::visit_fun(const NodeId id) {
+    const auto& def = ast.fun(id);
+    auto* f = declare(def.id, ast.types[id], def.is_internal);
+    if (def.is_internal) {
+        f->setLinkage(llvm::Function::InternalLinkage);
     }
 
     llvm::BasicBlock* bb = llvm::BasicBlock::Create(context, "entry", f);
     builder.SetInsertPoint(bb);
 
 
+    const auto params = ast.fun_params(id);
     llvm::IRBuilder<> tmpB(&f->getEntryBlock(), f->getEntryBlock().begin());
     for (auto& arg : f->args()) {
+        const auto& param = params[arg.getArgNo()];
+        // Calls declare functions without parameter names
+        arg.setName(param.id.str());
+        Symbol& sym = *param.sym;
+        // Only parameters that are reassigned need a stack slot
+        if (!sym.is_reassigned) {
+            sym.val = &arg;
+            continue;
+        }
         llvm::Type* argTy = arg.getType();
 
         llvm::AllocaInst* alloca = tmpB.CreateAlloca(argTy, nullptr, arg.getName());
 
         builder.CreateStore(&arg, alloca);
 
-        def.scope.get_symbol(std::string(arg.getName())).val = alloca;
+        sym.val = alloca;
     }
 
 
-    auto* v = def.body->codegen_accept(*this);
+    auto* v = dispatch(def.body);
     if (!builder.GetInsertBlock()->getTerminator()) {
         if (v) {
             builder.CreateRet(v);
-        } else if (def.signature.type) {
+        } else if (ast.types[id]) {
             builder.CreateRetVoid();
-        } else if (f->getReturnType()->isIntegerTy() && def.signature.id == "main") {
+        } else if (f->getReturnType()->isIntegerTy() && def.id == main_ident) {
             builder.CreateRet(llvm::ConstantInt::get(f->getReturnType(), 0));
         } else {
-            throw TokenError("Missing Function terminator outside a main function", def.loc);
+            throw TokenError("Missing Function terminator outside a main function", ast.locs[id]);
         }
     }
 
     llvm::verifyFunction(*f);
 }
 
-llvm::Function* CodegenVisitor::get_llvm_signature(const FunSignature &sig) const {
-    std::vector<llvm::Type*> arg_types;
-    arg_types.reserve(sig.args.size());
-    for (const auto& arg : sig.args) {
-        arg_types.push_back(get_llvm_type(arg.parent_scope->resolve(arg.id).value().type));
+std::string CodegenVisitor::link_name(const Ident id, const bool is_internal) const {
+    if (is_internal) {
+        return module.getName().str() + "." + std::string(id.str());
     }
-    const auto return_type = get_llvm_type(sig.anno.type);
+    return std::string(id.str());
+}
 
-    const auto ft = llvm::FunctionType::get(return_type, arg_types, false);
+llvm::Function* CodegenVisitor::declare(const Ident id, const Type* type, const bool is_internal) const {
+    const std::string name = link_name(id, is_internal);
+    if (auto* f = module.getFunction(name)) {
+        return f;
+    }
+    return get_llvm_signature(static_cast<const FunctionTy&>(*type), name);
+}
 
-    const auto function = llvm::Function::Create(ft, llvm::Function::ExternalLinkage, sig.id, &module);
-    int i = 0;
-    for (auto& arg: function->args()) {
-        arg.setName(sig.args[i++].id);
+llvm::Function* CodegenVisitor::get_llvm_signature(const FunctionTy& type, const std::string& name) const {
+    std::vector<llvm::Type*> arg_types;
+    arg_types.reserve(type.arg_types.size());
+    for (const Type* arg : type.arg_types) {
+        arg_types.push_back(get_llvm_type(arg));
     }
-    return function;
+    const auto return_type = get_llvm_type(type.return_type);
 
-}
+    const auto ft = llvm::FunctionType::get(return_type, arg_types, false);
 
-void CodegenVisitor::visit(const ExternalStmt &stmt) const {
-    auto* f = get_llvm_signature(stmt.signature);
+    return llvm::Function::Create(ft, llvm::Function::ExternalLinkage, name, &module);
 }
 
-void CodegenVisitor::visit(const VarInit& stmt) {
+void CodegenVisitor::visit_var(const NodeId id) {
+    const auto& stmt = ast.var(id);
+    Symbol& sym = *ast.syms[id];
+    // A binding that is never reassigned is its value, only variables that change live in memory
+    if (!sym.is_reassigned) {
+        llvm::Value* val = dispatch(stmt.val);
+        if (val && !val->hasName() && !llvm::isa<llvm::Constant>(val)) {
+            val->setName(stmt.id.str());
+        }
+        sym.val = val;
+        return;
+    }
     llvm::Function* fn = builder.GetInsertBlock()->getParent();
 
     llvm::IRBuilder<> tmpB(&fn->getEntryBlock(), fn->getEntryBlock().begin());
 
-    llvm::Type* llvmTy = get_llvm_type(stmt.val->type);
-    llvm::AllocaInst* alloca = tmpB.CreateAlloca(llvmTy, nullptr, stmt.id);
+    llvm::Type* llvmTy = get_llvm_type(ast.types[stmt.val]);
+    llvm::AllocaInst* alloca = tmpB.CreateAlloca(llvmTy, nullptr, stmt.id.str());
 
-    llvm::Value* initVal = stmt.val->codegen_accept(*this);
+    llvm::Value* initVal = dispatch(stmt.val);
 
     builder.CreateStore(initVal, alloca);
 
-    stmt.parent_scope->get_symbol(stmt.id).val = alloca;
+    sym.val = alloca;
 }
 
-void CodegenVisitor::visit(const Assignment &stmt) {
-    const auto& sym = stmt.parent_scope->get_symbol(stmt.assignee);
-    llvm::Value* alloca = sym.val;
+void CodegenVisitor::visit_assign(const NodeId id) {
+    llvm::Value* alloca = ast.syms[id]->val;
 
-    llvm::Value* rhs = stmt.val->codegen_accept(*this);
+    llvm::Value* rhs = dispatch(ast.assign(id).val);
 
     builder.CreateStore(rhs, alloca);
 }
@@ -0,0 +1,190 @@
+#include "build.h"
+
+#include <utility>
+
+#include "profiler.h"
+#include "stmt_nodes.h"
+#include "token_error.h"
+
+Build::Build(TypeInterner& types, const CompilerOptions& options)
+    : types(types), options(options), pool(options.jobs) {}
+
+void Build::load(const std::filesystem::path& root_file) {
+    {
+        std::lock_guard lock(mutex);
+        root_unit = unit_for(root_file);
+    }
+    pool.wait();
+    rethrow_error();
+}
+
+void Build::compile(const std::function<void(Phase)>& after_stage) {
+    check_cycles();
+    auto finished = [&](const Phase phase) {
+        if (after_stage) {
+            after_stage(phase);
+        }
+    };
+    run_in_import_order([](Unit& unit) {
+        PhaseScope scope(Phase::Sema, unit.module->name);
+        unit.module->run_sema();
+    });
+    finished(Phase::Sema);
+    run_in_import_order([](Unit& unit) {
+        PhaseScope scope(Phase::TypeCheck, unit.module->name);
+        unit.module->run_type_checker();
+    });
+    finished(Phase::TypeCheck);
+    check_exported_names();
+    run_on_all([](Unit& unit) {
+        PhaseScope scope(Phase::Codegen, unit.module->name);
+        unit.module->run_codegen();
+    });
+    finished(Phase::Codegen);
+    // The lazy JIT and the incremental compiler optimize every function when they compile it
+    if (!options.lazy && !options.incremental) {
+        run_on_all([this](Unit& unit) {
+            PhaseScope scope(Phase::Optimize, unit.module->name);
+            unit.module->optimize(options);
+        });
+        finished(Phase::Optimize);
+    }
+}
+
+Build::Unit* Build::unit_for(const std::filesystem::path& path) {
+    const std::string key = std::filesystem::weakly_canonical(path).string();
+    auto& unit = units[key];
+    if (!unit) {
+        unit = std::make_unique<Unit>();
+        unit->path = path;
+        unit->module = std::make_unique<Module>(path.stem().string(), types, options);
+        run([this, u = unit.get()] { parse(*u); });
+    }
+    return unit.get();
+}
+
+void Build::parse(Unit& unit) {
+    {
+        PhaseScope scope(Phase::Parse, unit.module->name);
+        unit.src = std::make_unique<SourceFile>(unit.path.string());
+        unit.module->parse(*unit.src);
+    }
+
+    const auto dir = unit.path.parent_path();
+    std::lock_guard lock(mutex);
+    for (ImportStmt* stmt : unit.module->imports()) {
+        const auto path = dir / (std::string(stmt->name.str()) + ".arc");
+        if (!std::filesystem::exists(path)) {
+            throw TokenError("Can't find module " + std::string(stmt->name.str()) + " at " + path.string(), stmt->loc);
+        }
+        Unit* imported = unit_for(path);
+        stmt->module = imported->module.get();
+        unit.imports.push_back({imported, stmt});
+        imported->importers.push_back(&unit);
+    }
+}
+
+void Build::run_in_import_order(const std::function<void(Unit&)>& step) {
+    order.clear();
+    // Collected up front, the first tasks already change the pending counts
+    std::vector<Unit*> ready;
+    for (const auto& [_, unit] : units) {
+        unit->pending = unit->imports.size();
+        if (unit->pending == 0) {
+            ready.push_back(unit.get());
+        }
+    }
+    std::function<void(Unit&)> run_step = [&](Unit& unit) {
+        step(unit);
+        std::lock_guard lock(mutex);
+        order.push_back(unit.module.get());
+        for (Unit* importer : unit.importers) {
+            if (--importer->pending == 0) {
+                run([&run_step, importer] { run_step(*importer); });
+            }
+        }
+    };
+    for (Unit* unit : ready) {
+        run([&run_step, unit] { run_step(*unit); });
+    }
+    pool.wait();
+    rethrow_error();
+}
+
+void Build::run_on_all(const std::function<void(Unit&)>& step) {
+    for (const auto& [_, unit] : units) {
+        run([&step, u = unit.get()] { step(*u); });
+    }
+    pool.wait();
+    rethrow_error();
+}
+
+void Build::run(std::function<void()> task) {
+    pool.submit([this, task = std::move(task)] {
+        {
+            std::lock_guard lock(mutex);
+            if (error) {
+                return;
+            }
+        }
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    });
+}
+
+void Build::rethrow_error() {
+    if (error) {
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+}
+
+// Follows imports from every unit until it either reaches a unit without imports or comes back
+// to a unit on the current path
+void Build::check_cycles() const {
+    enum class State { Unvisited, OnPath, Done };
+    std::unordered_map<const Unit*, State> states;
+
+    auto visit = [&](auto& self, const Unit& unit) -> void {
+        states[&unit] = State::OnPath;
+        for (const auto& [imported, stmt] : unit.imports) {
+            const State state = states[imported];
+            if (state == State::OnPath) {
+                throw TokenError("Import cycle: module " + unit.module->name + " imports " + imported->module->name +
+                                 ", which depends on " + unit.module->name, stmt->loc);
+            }
+            if (state == State::Unvisited) {
+                self(self, *imported);
+            }
+        }
+        states[&unit] = State::Done;
+    };
+    for (const auto& [_, unit] : units) {
+        if (states[unit.get()] == State::Unvisited) {
+            visit(visit, *unit);
+        }
+    }
+}
+
+// Functions that aren't internal keep their name when the modules are linked together
+void Build::check_exported_names() const {
+    std::unordered_map<Ident, const Module*> exported;
+    for (const Module* module : order) {
+        for (const auto& node : module->ast) {
+            const auto* def = node->kind == NodeKind::FunDef ? static_cast<const FunDef*>(node.get()) : nullptr;
+            if (!def || def->is_internal) {
+                continue;
+            }
+            const auto [it, inserted] = exported.emplace(def->signature.id, module);
+            if (!inserted) {
+                throw TokenError(std::string(def->signature.id.str()) + " is already defined in module "
+                                 + it->second->name + ", mark one of them as internal", def->signature.loc);
+            }
+        }
+    }
+}
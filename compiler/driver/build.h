@@ -0,0 +1,85 @@
+#pragma once
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler_options.h"
+#include "module.h"
+#include "profiler.h"
+#include "source_file.h"
+#include "thread_pool.h"
+
+class TypeInterner;
+
+// Compiles a program that is split over several files. `import name` refers to name.arc in the
+// directory of the importing file.
+//
+// load reads, lexes and parses the root file and every file it imports, each on the thread pool
+// as soon as the first import of it has been parsed. compile then runs one stage at a time over
+// all modules. Names are resolved and types checked in every module once the modules it imports
+// are done, so independent modules are handled in parallel. Lowering and optimizing only need
+// the types of imported functions, so they run on all modules at once. The first error of any
+// module is rethrown on the calling thread.
+class Build {
+public:
+    Build(TypeInterner& types, const CompilerOptions& options);
+
+    void load(const std::filesystem::path& root_file);
+
+    // after_stage is called on the calling thread once a stage has finished for every module
+    void compile(const std::function<void(Phase)>& after_stage = {});
+
+    Module& root() const { return *root_unit->module; }
+
+    // Every module after the modules it imports, only complete after compile
+    const std::vector<Module*>& modules() const { return order; }
+
+private:
+    struct Unit;
+
+    struct Import {
+        Unit* unit;
+        const ImportStmt* stmt;
+    };
+
+    struct Unit {
+        std::filesystem::path path;
+        std::unique_ptr<SourceFile> src;
+        std::unique_ptr<Module> module;
+        std::vector<Import> imports;
+        std::vector<Unit*> importers;
+        // Imports that aren't compiled yet
+        size_t pending = 0;
+    };
+
+    TypeInterner& types;
+    const CompilerOptions& options;
+    ThreadPool pool;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Unit>> units;
+    Unit* root_unit = nullptr;
+    std::vector<Module*> order;
+    std::exception_ptr error;
+
+    // The unit for a file, loading it on the pool the first time. Expects the mutex to be held.
+    Unit* unit_for(const std::filesystem::path& path);
+    void parse(Unit& unit);
+
+    // Runs step on every unit once it has run on the units it imports, and records that order
+    void run_in_import_order(const std::function<void(Unit&)>& step);
+    // Runs step on every unit at once
+    void run_on_all(const std::function<void(Unit&)>& step);
+
+    // Runs task on the pool unless a task has failed before, and records its exception
+    void run(std::function<void()> task);
+    void rethrow_error();
+
+    void check_cycles() const;
+    void check_exported_names() const;
+};
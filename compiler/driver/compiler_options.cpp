@@ -0,0 +1,20 @@
+#include "compiler_options.h"
+
+std::optional<OptLevel> opt_level_of(const std::string_view flag) {
+    using enum OptLevel;
+    if (flag == "-O0") return O0;
+    if (flag == "-O1") return O1;
+    if (flag == "-O2") return O2;
+    if (flag == "-O3") return O3;
+    if (flag == "-Os") return Os;
+    return std::nullopt;
+}
+
+std::optional<EmitKind> emit_kind_of(const std::string_view name) {
+    using enum EmitKind;
+    if (name == "exe") return Exe;
+    if (name == "obj") return Obj;
+    if (name == "asm") return Asm;
+    if (name == "bc") return Bc;
+    return std::nullopt;
+}
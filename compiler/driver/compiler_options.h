@@ -0,0 +1,57 @@
+#pragma once
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+enum class OptLevel {
+    O0, O1, O2, O3, Os
+};
+
+// The level for a command line flag like "-O2", if it is one
+std::optional<OptLevel> opt_level_of(std::string_view flag);
+
+// What `arco build` writes
+enum class EmitKind {
+    Exe, Obj, Asm, Bc
+};
+
+// The kind for the value of --emit=, like "obj"
+std::optional<EmitKind> emit_kind_of(std::string_view name);
+
+// More threads than this only add contention
+constexpr unsigned max_jobs = 256;
+
+struct CompilerOptions {
+    OptLevel opt_level = OptLevel::O2;
+    // Threads used to parse and compile modules
+    unsigned jobs = std::thread::hardware_concurrency();
+    // Empty means the host's CPU and features
+    std::string target_cpu;
+    // Comma separated, like "+avx2,-avx512f"
+    std::string target_features;
+    // Compile and optimize functions on their first call when running with the JIT
+    bool lazy = false;
+    // Compile every function on its own and reuse the objects of unchanged functions from the cache
+    bool incremental = false;
+    // Where the JIT keeps compiled objects between runs, empty disables the cache
+    std::filesystem::path cache_dir;
+    // Print the cache's hits and misses
+    bool cache_stats = false;
+    // Print how long every phase took
+    bool time_phases = false;
+    // Where to write a Chrome trace of the phases, functions and LLVM passes, empty for none
+    std::filesystem::path trace_file;
+    // Report memory use as JSON, to stderr unless mem_stats_file is set
+    bool mem_stats = false;
+    std::filesystem::path mem_stats_file;
+    // Instrument the program to count edges and calls, it writes the counts to profile_file at exit
+    bool profile_generate = false;
+    std::filesystem::path profile_file = "default.profraw";
+    // An indexed profile from llvm-profdata to optimize with, empty for none
+    std::filesystem::path profile_use;
+    EmitKind emit = EmitKind::Exe;
+    // Empty means the name of the root file with the emitted kind's extension
+    std::filesystem::path output;
+};
@@ -0,0 +1,96 @@
+#include "emit.h"
+
+#include <stdexcept>
+#include <string>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "module.h"
+#include "profiler.h"
+
+std::string_view extension_of(const EmitKind kind) {
+    switch (kind) {
+        case EmitKind::Exe: return "";
+        case EmitKind::Obj: return ".o";
+        case EmitKind::Asm: return ".s";
+        case EmitKind::Bc: return ".bc";
+    }
+    return "";
+}
+
+void emit_module(Module& module, const EmitKind kind, const std::filesystem::path& path) {
+    PhaseScope scope(Phase::Emit, module.name);
+    std::error_code ec;
+    llvm::raw_fd_ostream out(path.string(), ec, kind == EmitKind::Asm ? llvm::sys::fs::OF_Text : llvm::sys::fs::OF_None);
+    if (ec) {
+        throw std::runtime_error("Can't write " + path.string() + ": " + ec.message());
+    }
+    if (kind == EmitKind::Bc) {
+        llvm::WriteBitcodeToFile(*module.llvm_module, out);
+        return;
+    }
+    llvm::legacy::PassManager pm;
+    const auto type = kind == EmitKind::Asm ? llvm::CodeGenFileType::AssemblyFile : llvm::CodeGenFileType::ObjectFile;
+    if (module.target_machine->addPassesToEmitFile(pm, out, nullptr, type)) {
+        throw std::runtime_error("The target machine can't emit " + path.string());
+    }
+    pm.run(*module.llvm_module);
+}
+
+void link_executable(const std::vector<std::filesystem::path>& objects, const std::filesystem::path& output,
+                     const bool profile_runtime) {
+    PhaseScope scope(Phase::Link, output.string());
+    const auto cc = llvm::sys::findProgramByName(profile_runtime ? "clang" : "cc");
+    if (!cc) {
+        throw std::runtime_error(profile_runtime ? "Can't find clang to link the profile runtime with"
+                                 : "Can't find a C compiler (cc) to link with");
+    }
+    std::vector<std::string> args = {*cc, "-o", output.string()};
+    if (profile_runtime) {
+        args.emplace_back("-fprofile-instr-generate");
+    }
+    for (const auto& object : objects) {
+        args.push_back(object.string());
+    }
+    const std::vector<llvm::StringRef> arg_refs(args.begin(), args.end());
+    std::string error;
+    if (llvm::sys::ExecuteAndWait(*cc, arg_refs, std::nullopt, {}, 0, 0, &error) != 0) {
+        throw std::runtime_error("Linking " + output.string() + " failed" + (error.empty() ? "" : ": " + error));
+    }
+}
+
+void emit(const std::vector<Module*>& modules, const Module& root, const CompilerOptions& options) {
+    const auto extension = std::string(extension_of(options.emit));
+    if (options.emit != EmitKind::Exe) {
+        for (Module* module : modules) {
+            emit_module(*module, options.emit, module == &root ? options.output
+                        : options.output.parent_path() / (module->name + extension));
+        }
+        return;
+    }
+
+    std::vector<std::filesystem::path> objects;
+    auto remove_objects = [&] {
+        for (const auto& object : objects) {
+            std::filesystem::remove(object);
+        }
+    };
+    try {
+        for (Module* module : modules) {
+            llvm::SmallString<128> object;
+            if (const auto ec = llvm::sys::fs::createTemporaryFile(module->name, "o", object)) {
+                throw std::runtime_error("Can't create a temporary object file: " + ec.message());
+            }
+            objects.emplace_back(object.str().str());
+            emit_module(*module, EmitKind::Obj, objects.back());
+        }
+        link_executable(objects, options.output, options.profile_generate);
+    } catch (...) {
+        remove_objects();
+        throw;
+    }
+    remove_objects();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include "compiler_options.h"
+
+struct Module;
+
+// The extension of the files written for kind, empty for executables
+std::string_view extension_of(EmitKind kind);
+
+// Writes the module as an object file, assembly or bitcode for its target machine
+void emit_module(Module& module, EmitKind kind, const std::filesystem::path& path);
+
+// Links the objects and libc into an executable with the system's C compiler driver. Instrumented
+// objects need the profile runtime, which only clang ships.
+void link_executable(const std::vector<std::filesystem::path>& objects, const std::filesystem::path& output,
+                     bool profile_runtime = false);
+
+// Writes what options.emit asks for. The root module goes to options.output, every other module
+// to <module name>.<extension> next to it, or into a temporary object for executables.
+void emit(const std::vector<Module*>& modules, const Module& root, const CompilerOptions& options);
@@ -0,0 +1,132 @@
+#include "incremental.h"
+
+#include <stdexcept>
+#include <string>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include "module.h"
+#include "profiler.h"
+#include "target.h"
+
+IncrementalCompiler::IncrementalCompiler(const std::filesystem::path& cache_dir, const CompilerOptions& options)
+    : options(options),
+    target_machine(create_target_machine(options)),
+    cache(cache_dir, target_machine_builder(options), options.opt_level) {}
+
+// Declarations of the functions and copies of the constants that value refers to
+static void import_globals(const llvm::Value* value, llvm::Module& into, llvm::ValueToValueMapTy& map) {
+    if (map.count(value)) {
+        return;
+    }
+    if (const auto* callee = llvm::dyn_cast<llvm::Function>(value)) {
+        auto* declared = llvm::Function::Create(callee->getFunctionType(), llvm::GlobalValue::ExternalLinkage,
+                                                callee->getName(), into);
+        declared->copyAttributesFrom(callee);
+        declared->setLinkage(llvm::GlobalValue::ExternalLinkage);
+        map[value] = declared;
+    } else if (const auto* var = llvm::dyn_cast<llvm::GlobalVariable>(value)) {
+        auto* copied = new llvm::GlobalVariable(into, var->getValueType(), var->isConstant(), var->getLinkage(),
+                                                nullptr, var->getName());
+        copied->copyAttributesFrom(var);
+        map[value] = copied;
+        if (var->hasInitializer()) {
+            import_globals(var->getInitializer(), into, map);
+            copied->setInitializer(llvm::MapValue(var->getInitializer(), map));
+        }
+    } else if (const auto* constant = llvm::dyn_cast<llvm::Constant>(value)) {
+        for (const auto& operand : constant->operands()) {
+            import_globals(operand, into, map);
+        }
+    }
+}
+
+// A module with just the definition of function and what it refers to. Copying the rest of the
+// module would tie the function's IR to every other function and make splitting quadratic.
+static std::unique_ptr<llvm::Module> extract(const llvm::Module& module, const llvm::Function& function) {
+    auto extracted = std::make_unique<llvm::Module>(module.getModuleIdentifier(), module.getContext());
+    extracted->setSourceFileName(module.getSourceFileName());
+    extracted->setTargetTriple(module.getTargetTriple());
+    extracted->setDataLayout(module.getDataLayout());
+
+    llvm::ValueToValueMapTy map;
+    // Mapped first, so recursive calls refer to the copy instead of a declaration
+    auto* copy = llvm::Function::Create(function.getFunctionType(), function.getLinkage(), function.getName(), *extracted);
+    map[&function] = copy;
+    auto arg = copy->arg_begin();
+    for (const auto& original : function.args()) {
+        arg->setName(original.getName());
+        map[&original] = &*arg++;
+    }
+    for (const auto& block : function) {
+        for (const auto& inst : block) {
+            for (const auto& operand : inst.operands()) {
+                if (llvm::isa<llvm::Constant>(operand)) {
+                    import_globals(operand, *extracted, map);
+                }
+            }
+        }
+    }
+    llvm::SmallVector<llvm::ReturnInst*, 4> returns;
+    llvm::CloneFunctionInto(copy, &function, map, llvm::CloneFunctionChangeType::DifferentModule, returns);
+
+    // Numbered after the function's own constants, not the module's
+    size_t count = 0;
+    for (auto& var : extracted->globals()) {
+        if (var.hasLocalLinkage()) {
+            var.setName("const." + std::to_string(count++));
+        }
+    }
+    return extracted;
+}
+
+static std::string print(const llvm::Module& module) {
+    std::string ir;
+    llvm::raw_string_ostream out(ir);
+    module.print(out, nullptr);
+    out.flush();
+    return ir;
+}
+
+std::vector<std::unique_ptr<llvm::MemoryBuffer>> IncrementalCompiler::compile(Module& module) {
+    // Every function ends up in its own object, so internal functions have to be visible to the
+    // other objects. Their names already carry the module's name.
+    for (auto& function : *module.llvm_module) {
+        if (function.hasLocalLinkage()) {
+            function.setLinkage(llvm::GlobalValue::ExternalLinkage);
+            function.setVisibility(llvm::GlobalValue::HiddenVisibility);
+        }
+    }
+
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects;
+    llvm::orc::SimpleCompiler compile_object(*target_machine);
+    for (const auto& function : *module.llvm_module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+        const auto extracted = extract(*module.llvm_module, function);
+        const std::string ir = print(*extracted);
+        if (auto object = cache.load(ir)) {
+            objects.push_back(std::move(object));
+            continue;
+        }
+        const std::string name = function.getName().str();
+        {
+            PhaseScope scope(Phase::Optimize, name);
+            optimize_module(*extracted, *target_machine, options);
+        }
+        PhaseScope scope(Phase::Emit, name);
+        auto object = compile_object(*extracted);
+        if (!object) {
+            throw std::runtime_error("Can't compile " + name + ": "
+                                     + llvm::toString(object.takeError()));
+        }
+        cache.store(ir, (*object)->getMemBufferRef());
+        objects.push_back(std::move(*object));
+    }
+    module.llvm_module.reset();
+    return objects;
+}
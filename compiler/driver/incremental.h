@@ -0,0 +1,31 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "compiler_options.h"
+#include "object_cache.h"
+
+struct Module;
+
+// Compiles every function of a module into its own object. A function is printed together with
+// the declarations it references, so its IR only changes when its own code or the signature of
+// something it calls changes. Optimizing and lowering are skipped for every function whose IR is
+// found in the cache, which keeps an edit-run loop on a large file proportional to the edit.
+class IncrementalCompiler {
+public:
+    IncrementalCompiler(const std::filesystem::path& cache_dir, const CompilerOptions& options);
+
+    // Consumes the module's IR
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> compile(Module& module);
+
+    size_t reused() const { return cache.hits(); }
+    size_t compiled() const { return cache.misses(); }
+
+private:
+    CompilerOptions options;
+    std::unique_ptr<llvm::TargetMachine> target_machine;
+    DiskObjectCache cache;
+};
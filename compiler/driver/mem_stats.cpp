@@ -0,0 +1,229 @@
+#include "mem_stats.h"
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/Process.h>
+
+#include "expr_nodes.h"
+#include "module.h"
+#include "node_visitor.h"
+#include "stmt_nodes.h"
+#include "type_interner.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define ARCO_HAS_RUSAGE 1
+#endif
+
+namespace {
+
+// Adds up every node of an AST by kind, with the vectors it owns, and the scopes in it
+struct AstMemCounter final : NodeVisitor<AstMemCounter> {
+    MemStats& stats;
+
+    explicit AstMemCounter(MemStats& stats) : stats(stats) {}
+
+    template<typename Node>
+    void count(const Node& node, const size_t owned = 0) {
+        auto& [count, bytes] = stats.nodes[static_cast<size_t>(node.kind)];
+        count++;
+        bytes += sizeof(Node) + owned;
+    }
+
+    void count(const Scope& scope) {
+        auto& [count, symbols, bytes] = stats.scopes[static_cast<size_t>(scope.kind)];
+        count++;
+        symbols += scope.symbols.size();
+        bytes += scope.symbols.size() * sizeof(Symbol) + scope.symbols.bytes();
+    }
+
+    void visit(TypeAnno &) {}
+
+    void visit(ParenExpr &expr) { count(expr); dispatch(*expr.expr); }
+
+    void visit(BlockExpr &expr) {
+        count(expr, expr.body.capacity() * sizeof(StmtPtr));
+        count(expr.scope);
+        for (const auto& stmt : expr.body) {
+            dispatch(*stmt);
+        }
+    }
+
+    void visit(UnaryExpr &expr) { count(expr); dispatch(*expr.operand); }
+
+    void visit(BinaryExpr &expr) {
+        count(expr);
+        dispatch(*expr.lhs);
+        dispatch(*expr.rhs);
+    }
+
+    void visit(IdExpr &expr) { count(expr); }
+    void visit(IntConst &expr) { count(expr); }
+    void visit(FloatConst &expr) { count(expr); }
+    void visit(CharConst &expr) { count(expr); }
+    void visit(StringConst &expr) { count(expr); }
+    void visit(BoolConst &expr) { count(expr); }
+
+    void visit(FunCall &expr) {
+        count(expr, expr.args.capacity() * sizeof(ExprPtr));
+        for (const auto& arg : expr.args) {
+            dispatch(*arg);
+        }
+    }
+
+    void visit(IfElseExpr &expr) {
+        count(expr);
+        dispatch(*expr.condition);
+        dispatch(*expr.if_branch);
+        if (expr.else_branch.has_value()) {
+            dispatch(*expr.else_branch.value());
+        }
+    }
+
+    void visit(WhileExpr &expr) {
+        count(expr);
+        dispatch(*expr.condition);
+        dispatch(*expr.body);
+    }
+
+    void visit(ExprStmt &stmt) { count(stmt); dispatch(*stmt.expr); }
+
+    void visit(VarInit &stmt) { count(stmt); dispatch(*stmt.val); }
+
+    void visit(Assignment &stmt) { count(stmt); dispatch(*stmt.val); }
+
+    void visit(DefArg &) {}
+
+    void visit(FunSignature &) {}
+
+    void visit(FunDef &def) {
+        count(def, def.signature.args.capacity() * sizeof(DefArg));
+        count(def.scope);
+        dispatch(*def.body);
+    }
+
+    void visit(ExternalStmt &stmt) { count(stmt, stmt.signature.args.capacity() * sizeof(DefArg)); }
+
+    void visit(ImportStmt &stmt) { count(stmt); }
+};
+
+std::string_view str_of_scope_kind(const size_t kind) {
+    switch (static_cast<Scope::Kind>(kind)) {
+        case Scope::Kind::Block: return "block";
+        case Scope::Kind::Function: return "function";
+        case Scope::Kind::Module: return "module";
+    }
+    return "";
+}
+
+}
+
+// LLVM can only report the malloc'd bytes, not the peak resident set size
+static size_t peak_rss() {
+#ifdef ARCO_HAS_RUSAGE
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // ru_maxrss is in kilobytes everywhere but on macOS
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+void MemStats::sample(std::string phase) {
+    samples.push_back({std::move(phase), peak_rss(), llvm::sys::Process::GetMallocUsage()});
+}
+
+void MemStats::add(const Module& module) {
+    source_bytes += module.source_bytes;
+    tokens.count += module.token_count;
+    tokens.bytes += module.token_bytes;
+    arena_allocated += module.arena.bytes_allocated();
+    arena_reserved += module.arena.bytes_reserved();
+    flat_ast_bytes += module.flat_bytes;
+
+    AstMemCounter counter(*this);
+    counter.count(module.scope);
+    for (const auto& node : module.ast) {
+        counter.dispatch(*node);
+    }
+
+    if (module.llvm_module) {
+        for (const auto& function : *module.llvm_module) {
+            ir_functions++;
+            ir_blocks += function.size();
+            ir_instructions += function.getInstructionCount();
+        }
+    }
+}
+
+void MemStats::add(const TypeInterner& types) {
+    function_types = types.function_count();
+}
+
+void MemStats::add_object(const size_t bytes) {
+    jit_objects.count++;
+    jit_objects.bytes += bytes;
+}
+
+void MemStats::write_json(llvm::raw_ostream& out) const {
+    llvm::json::OStream json(out, 2);
+    auto count = [&](const Count& c) {
+        json.object([&] {
+            json.attribute("count", static_cast<int64_t>(c.count));
+            json.attribute("bytes", static_cast<int64_t>(c.bytes));
+        });
+    };
+    json.object([&] {
+        json.attributeArray("phases", [&] {
+            for (const auto& s : samples) {
+                json.object([&] {
+                    json.attribute("phase", s.phase);
+                    json.attribute("peak_rss", static_cast<int64_t>(s.peak_rss));
+                    json.attribute("malloc_bytes", static_cast<int64_t>(s.malloc_bytes));
+                });
+            }
+        });
+        json.attribute("source_bytes", static_cast<int64_t>(source_bytes));
+        json.attributeBegin("tokens");
+        count(tokens);
+        json.attributeEnd();
+        json.attributeObject("arena", [&] {
+            json.attribute("allocated", static_cast<int64_t>(arena_allocated));
+            json.attribute("reserved", static_cast<int64_t>(arena_reserved));
+        });
+        json.attributeObject("nodes", [&] {
+            for (size_t i = 0; i < nodes.size(); i++) {
+                json.attributeBegin(str_of_node_kind(static_cast<NodeKind>(i)));
+                count(nodes[i]);
+                json.attributeEnd();
+            }
+        });
+        json.attribute("flat_ast_bytes", static_cast<int64_t>(flat_ast_bytes));
+        json.attributeObject("scopes", [&] {
+            for (size_t i = 0; i < scopes.size(); i++) {
+                json.attributeObject(str_of_scope_kind(i), [&] {
+                    json.attribute("count", static_cast<int64_t>(scopes[i].count));
+                    json.attribute("symbols", static_cast<int64_t>(scopes[i].symbols));
+                    json.attribute("bytes", static_cast<int64_t>(scopes[i].bytes));
+                });
+            }
+        });
+        json.attribute("function_types", static_cast<int64_t>(function_types));
+        json.attributeObject("ir", [&] {
+            json.attribute("functions", static_cast<int64_t>(ir_functions));
+            json.attribute("blocks", static_cast<int64_t>(ir_blocks));
+            json.attribute("instructions", static_cast<int64_t>(ir_instructions));
+        });
+        json.attributeBegin("jit_objects");
+        count(jit_objects);
+        json.attributeEnd();
+    });
+    out << "\n";
+}
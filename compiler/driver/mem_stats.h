@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <llvm/Support/raw_ostream.h>
+
+#include "node_kind.h"
+
+struct Module;
+class TypeInterner;
+
+// What the compiler holds in memory, for --mem-stats. The process is sampled after every phase,
+// the AST, scopes and IR are counted once all modules are compiled and the JIT's objects as they
+// are linked.
+struct MemStats {
+    struct Sample {
+        std::string phase;
+        // 0 where the platform can't report it
+        size_t peak_rss = 0;
+        size_t malloc_bytes = 0;
+    };
+    struct Count {
+        size_t count = 0;
+        size_t bytes = 0;
+    };
+    struct ScopeCount {
+        size_t count = 0;
+        size_t symbols = 0;
+        // Symbols and symbol tables that outgrew their inline entries, the scopes themselves are
+        // part of the node that owns them
+        size_t bytes = 0;
+    };
+
+    std::vector<Sample> samples;
+    size_t source_bytes = 0;
+    Count tokens;
+    size_t arena_allocated = 0;
+    size_t arena_reserved = 0;
+    std::array<Count, node_kind_count> nodes{};
+    // The flattened AST codegen reads
+    size_t flat_ast_bytes = 0;
+    // Indexed by Scope::Kind
+    std::array<ScopeCount, 3> scopes{};
+    size_t function_types = 0;
+    size_t ir_functions = 0;
+    size_t ir_blocks = 0;
+    size_t ir_instructions = 0;
+    // Objects the JIT linked, which it compiles on the thread that looks up symbols
+    Count jit_objects;
+
+    void sample(std::string phase);
+
+    // Expects the module to be compiled and its IR not yet handed to the JIT
+    void add(const Module& module);
+    void add(const TypeInterner& types);
+    void add_object(size_t bytes);
+
+    void write_json(llvm::raw_ostream& out) const;
+};
@@ -1,5 +1,7 @@
 #include "module.h"
 
+#include <optional>
+#include <stdexcept>
 #include <utility>
 #include <llvm/IR/PassManager.h>
 #include <llvm/IR/Verifier.h>
@@ -7,28 +9,43 @@
 #include "llvm/Analysis/LoopAnalysisManager.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/Support/PGOOptions.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Transforms/IPO/HotColdSplitting.h"
 #include "llvm/Transforms/Utils/Mem2Reg.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
+#include "llvm/Transforms/Scalar/GVN.h"
 #include "llvm/Transforms/Scalar/Reassociate.h"
+#include "llvm/Transforms/Scalar/SimplifyCFG.h"
 
 #include "module_collector.h"
 #include "name_resolution.h"
 #include "parser.h"
 #include "scope.h"
+#include "source_file.h"
+#include "stmt_nodes.h"
+#include "target.h"
+#include "token_buffer.h"
 #include "type_checker.h"
 #include "codegen_visitor.h"
 
-Module::Module(std::string name, llvm::LLVMContext& ctx, TypeChecker& ty)
+Module::Module(std::string name, TypeInterner& types, const CompilerOptions& options)
     : name(std::move(name)),
-    scope(Scope::Kind::Module),
-    ctx(ctx),
-    llvm_module(std::make_unique<llvm::Module>(name, ctx)),
-    builder(ctx),
-    type_checker(ty),
-    codegen_visitor(ctx, builder, *llvm_module, scope, ty) {
+    scope(Scope::Kind::Module, arena),
+    ctx(std::make_unique<llvm::LLVMContext>()),
+    target_machine(create_target_machine(options)),
+    llvm_module(std::make_unique<llvm::Module>(this->name, *ctx)),
+    builder(*ctx),
+    type_checker(types),
+    codegen_visitor(*ctx, builder, *llvm_module, scope, type_checker, flat) {
+    llvm_module->setTargetTriple(target_machine->getTargetTriple().str());
+    llvm_module->setDataLayout(target_machine->createDataLayout());
+
     llvm::FunctionType *printfType = llvm::FunctionType::get(
-        llvm::IntegerType::getInt32Ty(ctx),
-        llvm::PointerType::get(llvm::Type::getInt8Ty(ctx), 0),
+        llvm::IntegerType::getInt32Ty(*ctx),
+        llvm::PointerType::get(llvm::Type::getInt8Ty(*ctx), 0),
         true// isVarArg
     );
 
@@ -43,55 +60,137 @@ Module::Module(std::string name, llvm::LLVMContext& ctx, TypeChecker& ty)
 }
 
 void Module::parse(SourceFile& src) {
-    ast = parse_file(src);
+    const TokenBuffer tokens(src);
+    source_bytes = src.text().size();
+    token_count = tokens.size();
+    token_bytes = tokens.bytes();
+    ast = parse_file(tokens, arena);
+}
+
+std::vector<ImportStmt*> Module::imports() const {
+    std::vector<ImportStmt*> result;
+    for (const auto& node : ast) {
+        if (node->kind == NodeKind::Import) {
+            result.push_back(static_cast<ImportStmt*>(node.get()));
+        }
+    }
+    return result;
 }
 
 
 void Module::run_sema() {
     ModuleCollector mc(scope);
     for (const auto& node : ast) {
-        node->accept(mc);
+        mc.dispatch(*node);
     }
     NameResolution nr(&scope);
     for (const auto& node : ast) {
-        node->accept(nr);
+        nr.dispatch(*node);
     }
 }
 
+// The name of a top level function for the trace, empty for other statements
+static std::string_view function_name(const Stmt& node) {
+    return node.kind == NodeKind::FunDef ? static_cast<const FunDef&>(node).signature.id.str() : std::string_view{};
+}
+
 void Module::run_type_checker() {
     for (const auto& node: ast) {
-        node->accept(type_checker);
+        llvm::TimeTraceScope scope("type check function", function_name(*node));
+        type_checker.dispatch(*node);
     }
 }
 
 void Module::run_codegen() {
-    for (const auto& node : ast) {
-        node->codegen_accept(codegen_visitor);
+    flat = flatten(ast);
+    flat_bytes = flat.bytes();
+    for (const NodeId root : flat.roots) {
+        llvm::TimeTraceScope scope("codegen function",
+                                   flat.kind(root) == NodeKind::FunDef ? flat.fun(root).id.str() : std::string_view{});
+        codegen_visitor.dispatch(root);
+    }
+    flat = FlatAst();
+    // The optimizer and the backends assume valid IR, so a module that isn't must not reach them
+    std::string errors;
+    llvm::raw_string_ostream out(errors);
+    if (llvm::verifyModule(*llvm_module, &out)) {
+        throw std::runtime_error("Invalid IR generated for module " + name + ":\n" + out.str());
+    }
+}
+
+void Module::optimize(const CompilerOptions& options) {
+    optimize_module(*llvm_module, *target_machine, options);
+}
+
+// Edge and call counters for --profile-generate, or the counts of --profile-use
+static std::optional<llvm::PGOOptions> pgo_options(const CompilerOptions& options) {
+    if (options.profile_generate) {
+        return llvm::PGOOptions(options.profile_file.string(), "", "", "", llvm::vfs::getRealFileSystem(), llvm::PGOOptions::IRInstr);
+    }
+    if (!options.profile_use.empty()) {
+        return llvm::PGOOptions(options.profile_use.string(), "", "", "", llvm::vfs::getRealFileSystem(), llvm::PGOOptions::IRUse);
+    }
+    return std::nullopt;
+}
+
+// -O1 only runs a few cheap per-function passes, the other levels run LLVM's default pipelines.
+// Profiles are only instrumented and read by LLVM's pipelines, so they're used at every level.
+void optimize_module(llvm::Module& module, llvm::TargetMachine& target_machine, const CompilerOptions& options) {
+    const auto pgo = pgo_options(options);
+    const OptLevel level = options.opt_level;
+    if (level == OptLevel::O0 && !pgo) {
+        return;
     }
     llvm::LoopAnalysisManager LAM;
     llvm::FunctionAnalysisManager FAM;
     llvm::CGSCCAnalysisManager CGAM;
     llvm::ModuleAnalysisManager MAM;
 
-    llvm::PassBuilder PB;
-
-    llvm::FunctionPassManager FPM;
-
-    FPM.addPass(llvm::PromotePass());
-    FPM.addPass(llvm::InstCombinePass());
-    FPM.addPass(llvm::ReassociatePass());
+    // Records every pass in the trace when --trace is given
+    llvm::PassInstrumentationCallbacks PIC;
+    llvm::TimeProfilingPassesHandler pass_timer;
+    pass_timer.registerCallbacks(PIC);
+
+    // Gives the optimizer the target's cost model, vector width and scheduling model. With a profile it also
+    // weights the branches and inlines the hot calls.
+    llvm::PassBuilder PB(&target_machine, llvm::PipelineTuningOptions(), pgo, &PIC);
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+    if (level == OptLevel::O1 && !pgo) {
+        llvm::FunctionPassManager FPM;
+        FPM.addPass(llvm::PromotePass());
+        FPM.addPass(llvm::InstCombinePass());
+        FPM.addPass(llvm::ReassociatePass());
+        FPM.addPass(llvm::GVNPass());
+        FPM.addPass(llvm::SimplifyCFGPass());
+        for (auto& function : module) {
+            if (!function.isDeclaration()) {
+                FPM.run(function, FAM);
+            }
+        }
+        return;
+    }
 
-    // PB.registerModuleAnalyses(MAM);
-    // PB.registerCGSCCAnalyses(CGAM);
-    // PB.registerFunctionAnalyses(FAM);
-    // PB.registerLoopAnalyses(LAM);
-    // PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    // Moves the regions the profile never reached out of the hot functions, so these stay small and dense
+    if (!options.profile_use.empty()) {
+        PB.registerOptimizerLastEPCallback([](llvm::ModulePassManager& MPM, llvm::OptimizationLevel) {
+            MPM.addPass(llvm::HotColdSplittingPass());
+        });
+    }
 
-    // llvm::ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
-    // MPM.run(*llvm_module, MAM);
-    if (llvm::verifyModule(*llvm_module, &llvm::errs())) {
-        llvm::errs() << "Invalid IR generated!\n";
-        llvm_module->print(llvm::errs(), nullptr);
-        return;
+    llvm::ModulePassManager MPM;
+    if (level == OptLevel::O0) {
+        MPM = PB.buildO0DefaultPipeline(llvm::OptimizationLevel::O0);
+    } else {
+        const auto llvm_level = level == OptLevel::O1 ? llvm::OptimizationLevel::O1
+                                : level == OptLevel::O2 ? llvm::OptimizationLevel::O2
+                                : level == OptLevel::O3 ? llvm::OptimizationLevel::O3
+                                : llvm::OptimizationLevel::Os;
+        MPM = PB.buildPerModuleDefaultPipeline(llvm_level);
     }
+    MPM.run(module, MAM);
 }
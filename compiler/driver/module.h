@@ -3,33 +3,57 @@
 #include <string>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
 
+#include "arena.h"
 #include "codegen_visitor.h"
+#include "flat_ast.h"
+#include "compiler_options.h"
 #include "scope.h"
 #include "type_checker.h"
 
 
-struct TypeChecker;
+struct ImportStmt;
+class TypeInterner;
 
 struct Module {
     std::string name;
+    // The token stream only lives while the module is parsed, its size is kept for --mem-stats
+    size_t source_bytes = 0;
+    size_t token_count = 0;
+    size_t token_bytes = 0;
+    // Owns the AST and every scope in it, so it has to be destroyed last
+    Arena arena;
     Scope scope;
     std::vector<StmtPtr> ast;
-    llvm::LLVMContext& ctx;
+    // Codegen reads the flattened AST, it only lives while the module is lowered
+    FlatAst flat;
+    size_t flat_bytes = 0;
+    // Every module has its own context, so modules can be lowered on different threads
+    std::unique_ptr<llvm::LLVMContext> ctx;
+    std::unique_ptr<llvm::TargetMachine> target_machine;
     std::unique_ptr<llvm::Module> llvm_module;
     llvm::IRBuilder<> builder;
     TypeChecker type_checker;
     CodegenVisitor codegen_visitor;
 
-
-
-    Module(std::string name, llvm::LLVMContext& ctx, TypeChecker& ty);
+    Module(std::string name, TypeInterner& types, const CompilerOptions& options);
 
     void parse(SourceFile& src);
 
+    // The import statements at the top of the AST
+    std::vector<ImportStmt*> imports() const;
+
     void run_sema();
 
     void run_type_checker();
 
+    // Throws if the generated IR doesn't verify
     void run_codegen();
+
+    void optimize(const CompilerOptions& options);
 };
+
+// Runs the pipeline for the optimization level over the module, instrumenting it or applying a profile if the
+// options ask for it. Also used by the lazy JIT on every function it compiles.
+void optimize_module(llvm::Module& module, llvm::TargetMachine& target_machine, const CompilerOptions& options);
@@ -0,0 +1,101 @@
+#include "object_cache.h"
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+
+DiskObjectCache::DiskObjectCache(std::filesystem::path dir, const llvm::orc::JITTargetMachineBuilder& target,
+                                 const OptLevel level)
+    : dir(std::move(dir)),
+    config(target.getTargetTriple().str() + "\n" + target.getCPU() + "\n" + target.getFeatures().getString()
+           + "\n" + std::to_string(static_cast<int>(level)) + "\n") {}
+
+static std::string print(const llvm::Module& module) {
+    std::string ir;
+    llvm::raw_string_ostream out(ir);
+    module.print(out, nullptr);
+    out.flush();
+    return ir;
+}
+
+std::filesystem::path DiskObjectCache::path_for(const std::string_view ir) const {
+    llvm::SHA1 hasher;
+    hasher.update(config);
+    hasher.update(llvm::StringRef(ir.data(), ir.size()));
+    return dir / (llvm::toHex(hasher.final(), true) + ".o");
+}
+
+void DiskObjectCache::notifyObjectCompiled(const llvm::Module* module, const llvm::MemoryBufferRef object) {
+    std::filesystem::path path;
+    {
+        std::lock_guard lock(mutex);
+        if (const auto it = missed.find(module); it != missed.end()) {
+            path = std::move(it->second);
+            missed.erase(it);
+        }
+    }
+    store_path(path.empty() ? path_for(print(*module)) : path, object);
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::getObject(const llvm::Module* module) {
+    auto path = path_for(print(*module));
+    auto object = load_path(path);
+    if (!object) {
+        std::lock_guard lock(mutex);
+        missed[module] = std::move(path);
+    }
+    return object;
+}
+
+void DiskObjectCache::store(const std::string_view ir, const llvm::MemoryBufferRef object) {
+    store_path(path_for(ir), object);
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::load(const std::string_view ir) {
+    return load_path(path_for(ir));
+}
+
+void DiskObjectCache::store_path(const std::filesystem::path& path, const llvm::MemoryBufferRef object) const {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    llvm::SmallString<128> tmp;
+    int fd;
+    // A cache that can't be written only costs the next run its warm start
+    if (ec || llvm::sys::fs::createUniqueFile((path.string() + ".%%%%%%.tmp"), fd, tmp)) {
+        return;
+    }
+    {
+        llvm::raw_fd_ostream out(fd, true);
+        out << object.getBuffer();
+        if (out.has_error()) {
+            out.clear_error();
+            llvm::sys::fs::remove(tmp);
+            return;
+        }
+    }
+    if (llvm::sys::fs::rename(tmp, path.string())) {
+        llvm::sys::fs::remove(tmp);
+    }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::load_path(const std::filesystem::path& path) {
+    auto buffer = llvm::MemoryBuffer::getFile(path.string());
+    if (!buffer) {
+        ++miss_count;
+        return nullptr;
+    }
+    ++hit_count;
+    return std::move(*buffer);
+}
+
+std::filesystem::path default_cache_dir() {
+    llvm::SmallString<128> dir;
+    if (!llvm::sys::path::cache_directory(dir)) {
+        return std::filesystem::temp_directory_path() / "arco";
+    }
+    return std::filesystem::path(dir.str().str()) / "arco";
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+
+#include "compiler_options.h"
+
+// Keeps the objects the JIT compiles in a directory, so unchanged modules skip codegen on later
+// runs. An object is keyed by a hash of the optimized IR together with the target triple, CPU,
+// features and optimization level. Files are written to a temporary name and then renamed, so
+// concurrent runs never read half written objects.
+class DiskObjectCache final : public llvm::ObjectCache {
+public:
+    DiskObjectCache(std::filesystem::path dir, const llvm::orc::JITTargetMachineBuilder& target, OptLevel level);
+
+    void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override;
+
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+    // The same lookups for callers that print and compile the code themselves
+    std::unique_ptr<llvm::MemoryBuffer> load(std::string_view ir);
+    void store(std::string_view ir, llvm::MemoryBufferRef object);
+
+    size_t hits() const { return hit_count; }
+    size_t misses() const { return miss_count; }
+
+private:
+    std::filesystem::path dir;
+    // Everything besides the IR that changes the generated code
+    std::string config;
+    std::atomic<size_t> hit_count = 0;
+    std::atomic<size_t> miss_count = 0;
+    // The paths getObject missed, so notifyObjectCompiled doesn't print and hash the module again
+    std::mutex mutex;
+    std::unordered_map<const llvm::Module*, std::filesystem::path> missed;
+
+    std::filesystem::path path_for(std::string_view ir) const;
+    std::unique_ptr<llvm::MemoryBuffer> load_path(const std::filesystem::path& path);
+    void store_path(const std::filesystem::path& path, llvm::MemoryBufferRef object) const;
+};
+
+// The directory the cache uses unless --cache-dir= names another one
+std::filesystem::path default_cache_dir();
@@ -0,0 +1,110 @@
+#include "profiler.h"
+
+#include <string>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/raw_ostream.h>
+
+// Events shorter than this many microseconds are left out of the trace, most passes over a small
+// function take less and would make traces of big programs hard to load
+static constexpr unsigned trace_granularity = 10;
+
+static std::atomic<Profiler*> instance = nullptr;
+// The innermost phase on this thread
+static thread_local PhaseScope* active_scope = nullptr;
+
+std::string_view str_of_phase(const Phase phase) {
+    switch (phase) {
+        case Phase::Parse: return "parse";
+        case Phase::Sema: return "sema";
+        case Phase::TypeCheck: return "type check";
+        case Phase::Codegen: return "codegen";
+        case Phase::Optimize: return "optimize";
+        case Phase::Emit: return "emit";
+        case Phase::Link: return "link";
+        case Phase::Jit: return "jit";
+    }
+    return "";
+}
+
+Profiler::Profiler(const bool time_phases, std::filesystem::path trace_file)
+    : time_phases(time_phases), trace_file(std::move(trace_file)) {
+    if (!this->trace_file.empty()) {
+        llvm::timeTraceProfilerInitialize(trace_granularity, "arco");
+    }
+    instance = this;
+}
+
+Profiler::~Profiler() {
+    instance = nullptr;
+    if (time_phases) {
+        print_phases();
+    }
+    if (trace_file.empty()) {
+        return;
+    }
+    if (auto error = llvm::timeTraceProfilerWrite(trace_file.string(), "arco")) {
+        llvm::errs() << "Can't write the trace: " << llvm::toString(std::move(error)) << "\n";
+    }
+    llvm::timeTraceProfilerCleanup();
+}
+
+Profiler* Profiler::current() {
+    return instance;
+}
+
+void Profiler::add(const Phase phase, const std::chrono::nanoseconds time) {
+    nanos[static_cast<size_t>(phase)] += time.count();
+}
+
+void Profiler::thread_started() {
+    if (const auto* profiler = current(); profiler && !profiler->trace_file.empty()) {
+        llvm::timeTraceProfilerInitialize(trace_granularity, "arco");
+    }
+}
+
+void Profiler::thread_finished() {
+    if (llvm::timeTraceProfilerEnabled()) {
+        llvm::timeTraceProfilerFinishThread();
+    }
+}
+
+// Phases of different modules overlap when they run on several threads, so the phases can add
+// up to more than the wall time
+void Profiler::print_phases() const {
+    using ms = std::chrono::duration<double, std::milli>;
+    const double wall = ms(std::chrono::steady_clock::now() - start).count();
+    llvm::errs() << llvm::formatv("{0,-12} {1,10} {2,8}\n", "phase", "ms", "% wall");
+    for (size_t i = 0; i < phase_count; i++) {
+        const double time = static_cast<double>(nanos[i]) / 1e6;
+        llvm::errs() << llvm::formatv("{0,-12} {1,10:f2} {2,7:f1}%\n", str_of_phase(static_cast<Phase>(i)),
+                                      time, 100 * time / wall);
+    }
+    llvm::errs() << llvm::formatv("{0,-12} {1,10:f2}\n", "wall", wall);
+}
+
+PhaseScope::PhaseScope(const Phase phase, const std::string_view detail)
+    : profiler(Profiler::current()), phase(phase) {
+    if (!profiler) {
+        return;
+    }
+    start = std::chrono::steady_clock::now();
+    outer = active_scope;
+    if (outer) {
+        profiler->add(outer->phase, start - outer->start);
+    }
+    active_scope = this;
+    trace.emplace(str_of_phase(phase), llvm::StringRef(detail.data(), detail.size()));
+}
+
+PhaseScope::~PhaseScope() {
+    if (profiler) {
+        trace.reset();
+        const auto end = std::chrono::steady_clock::now();
+        profiler->add(phase, end - start);
+        active_scope = outer;
+        if (outer) {
+            outer->start = end;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <llvm/Support/TimeProfiler.h>
+
+enum class Phase {
+    Parse, Sema, TypeCheck, Codegen, Optimize, Emit, Link, Jit
+};
+inline constexpr size_t phase_count = static_cast<size_t>(Phase::Jit) + 1;
+
+std::string_view str_of_phase(Phase phase);
+
+// Sums up the time spent in every phase for --time-phases and records Chrome trace events,
+// including one per LLVM pass, for --trace. There is at most one per process. It prints the
+// table and writes the trace when it is destroyed, which has to happen after the threads that
+// recorded events are joined.
+class Profiler {
+public:
+    Profiler(bool time_phases, std::filesystem::path trace_file);
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // The profiler of the process, nullptr when neither flag is given
+    static Profiler* current();
+
+    void add(Phase phase, std::chrono::nanoseconds time);
+
+    // Threads other than the main thread record their own trace events and hand them over when
+    // they finish
+    static void thread_started();
+    static void thread_finished();
+
+private:
+    bool time_phases;
+    std::filesystem::path trace_file;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::array<std::atomic<int64_t>, phase_count> nanos{};
+
+    void print_phases() const;
+};
+
+// Counts the time until the end of the scope towards phase. A nested scope pauses the one around
+// it, so every phase in the table only counts its own time. The trace event is named after the
+// phase, detail says what it worked on, like a module or function name.
+class PhaseScope {
+public:
+    explicit PhaseScope(Phase phase, std::string_view detail = {});
+    ~PhaseScope();
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    Profiler* profiler;
+    PhaseScope* outer = nullptr;
+    Phase phase;
+    std::chrono::steady_clock::time_point start;
+    std::optional<llvm::TimeTraceScope> trace;
+};
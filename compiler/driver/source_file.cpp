@@ -1,32 +1,163 @@
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 #include "source_file.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ARCO_HAS_MMAP 1
+#endif
+
+#ifdef ARCO_HAS_MMAP
+// Maps the file if it already ends with a newline, so the mapping can be used as is
+static void* map_file(const std::string& filename, size_t& mapping_size) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st{};
+    void* mapping = nullptr;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        mapping_size = static_cast<size_t>(st.st_size);
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+        } else if (static_cast<const char*>(mapping)[mapping_size - 1] != '\n') {
+            munmap(mapping, mapping_size);
+            mapping = nullptr;
+        }
+    }
+    close(fd);
+    return mapping;
+}
+#endif
+
 SourceFile::SourceFile(const std::string &filename)
     : filename(filename) {
-    std::ifstream in(filename);
+#ifdef ARCO_HAS_MMAP
+    mapping = map_file(filename, mapping_size);
+    if (mapping) {
+        data = static_cast<const char*>(mapping);
+        size = mapping_size;
+        index_lines();
+        add_to_registry();
+        return;
+    }
+#endif
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
     if (!in.is_open()) {
         throw std::runtime_error("Couldn't open file: " + filename);
     }
-    std::string line;
-    while (std::getline(in, line)) {
-        lines.push_back(line + "\n");
-    }
-    if (lines.empty()) {
-        lines.emplace_back("\n");
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (buffer.empty() || buffer.back() != '\n') {
+        buffer += '\n';
     }
+    use_buffer();
 }
 
 SourceFile::SourceFile(const std::vector<std::string> &src)
     : filename("testing") {
     for (const auto& line: src) {
-        lines.push_back(line + "\n");
+        buffer += line;
+        buffer += '\n';
+    }
+    use_buffer();
+}
+
+// Ranges are handed out in increasing order and never reused, so the registry stays sorted by base
+static std::shared_mutex registry_mutex;
+static std::vector<SourceFile*> registry;
+static uint64_t next_base = 0;
+
+static bool base_less(const SourceFile* file, const uint32_t pos) {
+    return file->base < pos;
+}
+
+void SourceFile::add_to_registry() {
+    std::unique_lock lock(registry_mutex);
+    if (next_base + size + 1 > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too much source code to compile at once: " + filename);
+    }
+    base = static_cast<uint32_t>(next_base);
+    next_base += size + 1;
+    registry.push_back(this);
+}
+
+SourceFile& SourceFile::containing(const uint32_t pos) {
+    std::shared_lock lock(registry_mutex);
+    const auto it = std::upper_bound(registry.begin(), registry.end(), pos,
+        [](const uint32_t p, const SourceFile* file) { return p < file->base; });
+    if (it == registry.begin()) {
+        throw std::out_of_range("No source file contains offset " + std::to_string(pos));
     }
+    return **std::prev(it);
 }
 
-std::string& SourceFile::get_line(const int n) {
-    return lines.at(n-1);
+SourceFile::~SourceFile() {
+    {
+        std::unique_lock lock(registry_mutex);
+        const auto it = std::lower_bound(registry.begin(), registry.end(), base, base_less);
+        if (it != registry.end() && *it == this) {
+            registry.erase(it);
+        }
+    }
+#ifdef ARCO_HAS_MMAP
+    if (mapping) {
+        munmap(mapping, mapping_size);
+    }
+#endif
+}
+
+void SourceFile::use_buffer() {
+    data = buffer.data();
+    size = buffer.size();
+    index_lines();
+    add_to_registry();
+}
+
+void SourceFile::index_lines() {
+    line_starts.clear();
+    line_starts.reserve(size / 32 + 2);
+    size_t start = 0;
+    while (start < size) {
+        line_starts.push_back(start);
+        const auto* nl = static_cast<const char*>(std::memchr(data + start, '\n', size - start));
+        start = static_cast<size_t>(nl - data) + 1;
+    }
+    line_starts.push_back(size);
+}
+
+std::string_view SourceFile::get_line(const int n) const {
+    if (n < 1 || n > length()) {
+        throw std::out_of_range("Line " + std::to_string(n) + " is out of range");
+    }
+    const size_t start = line_starts[n-1];
+    return {data + start, line_starts[n] - start};
 }
 
 int SourceFile::length() const {
-    return static_cast<int>(lines.size());
-}
\ No newline at end of file
+    return static_cast<int>(line_starts.size()) - 1;
+}
+
+size_t SourceFile::line_offset(const int n) const {
+    return line_starts.at(n-1);
+}
+
+Position SourceFile::position(const size_t offset) const {
+    // The sentinel is left out, so the end of file belongs to the last line
+    const auto it = std::upper_bound(line_starts.begin(), line_starts.end() - 1, offset);
+    const auto line = static_cast<int>(it - line_starts.begin());
+    if (line == 0) {
+        return {1, 1};
+    }
+    return {line, static_cast<int>(offset - line_starts[line - 1]) + 1};
+}
@@ -1,20 +1,58 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
+#include "location.h"
+
+// The whole file is kept in one contiguous buffer (memory-mapped when possible).
+// Every line, including the last one, is terminated by '\n'.
 struct SourceFile {
     std::string filename;
+    // Start of the file's range in the offset space shared by all files. The range covers
+    // every byte of the file and the end of file.
+    uint32_t base = 0;
 
     explicit SourceFile(const std::string& filename);
 
     // For testing only
     explicit SourceFile(const std::vector<std::string> &src);
 
-    // 1-based indexing
-    std::string& get_line(int);
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    // 1-based indexing, the view includes the trailing '\n'
+    std::string_view get_line(int) const;
 
     int length() const;
 
+    std::string_view text() const { return {data, size}; }
+
+    // Byte offset of the first character of a line (1-based)
+    size_t line_offset(int) const;
+
+    // Line and column of a byte offset
+    Position position(size_t offset) const;
+
+    // The file whose range contains a global offset, safe to call from any thread
+    static SourceFile& containing(uint32_t pos);
+
 private:
-    std::vector<std::string> lines;
+    const char* data = nullptr;
+    size_t size = 0;
+
+    // Only set when the file is memory-mapped, otherwise the contents live in buffer
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::string buffer;
+
+    // Offsets of the first character of every line, followed by size as a sentinel
+    std::vector<size_t> line_starts;
+
+    void use_buffer();
+    void index_lines();
+    void add_to_registry();
 };
@@ -0,0 +1,23 @@
+#include "target.h"
+
+#include <llvm/Support/Error.h>
+
+llvm::orc::JITTargetMachineBuilder target_machine_builder(const CompilerOptions& options) {
+    auto builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+    if (!options.target_cpu.empty()) {
+        // The host's features would leak into a build for another CPU
+        builder.setCPU(options.target_cpu);
+        builder.setFeatures("");
+    }
+    if (!options.target_features.empty()) {
+        builder.setFeatures(options.target_features);
+    }
+    return builder;
+}
+
+std::unique_ptr<llvm::TargetMachine> create_target_machine(const CompilerOptions& options) {
+    // Executables are position independent by default, so their objects have to be as well
+    auto builder = target_machine_builder(options);
+    builder.setRelocationModel(llvm::Reloc::PIC_);
+    return llvm::cantFail(builder.createTargetMachine());
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <memory>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "compiler_options.h"
+
+// Describes the machine the code runs on: the host, unless the options name a CPU or features
+llvm::orc::JITTargetMachineBuilder target_machine_builder(const CompilerOptions& options);
+
+// A target machine is not thread-safe, so every module creates its own
+std::unique_ptr<llvm::TargetMachine> create_target_machine(const CompilerOptions& options);
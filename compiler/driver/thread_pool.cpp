@@ -0,0 +1,62 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+#include "profiler.h"
+
+ThreadPool::ThreadPool(const unsigned threads) {
+    for (unsigned i = 0; i < std::max(threads, 1u); i++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock(mutex);
+    idle.wait(lock, [this] { return tasks.empty() && running == 0; });
+}
+
+void ThreadPool::work() {
+    Profiler::thread_started();
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            work_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                break;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            running++;
+        }
+        task();
+        {
+            std::lock_guard lock(mutex);
+            running--;
+            if (tasks.empty() && running == 0) {
+                idle.notify_all();
+            }
+        }
+    }
+    Profiler::thread_finished();
+}
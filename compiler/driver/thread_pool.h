@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed number of worker threads that run the submitted tasks in order. Tasks may submit
+// further tasks. The destructor waits for all tasks to finish.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until no task is queued or running
+    void wait();
+
+private:
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable idle;
+    std::deque<std::function<void()>> tasks;
+    size_t running = 0;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void work();
+};
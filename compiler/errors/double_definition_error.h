@@ -1,6 +1,7 @@
 #pragma once
 #include <exception>
 #include <string>
+#include <string_view>
 
 #include "error_msg.h"
 
@@ -8,8 +9,8 @@ class DoubleDefinitionError final : public std::exception {
     std::string full_msg;
 
 public:
-    DoubleDefinitionError(const std::string& id, const Location& loc)
-        : full_msg(token_message(loc, id + " has already been defined")) {}
+    DoubleDefinitionError(const std::string_view id, const Location& loc)
+        : full_msg(token_message(loc, std::string(id) + " has already been defined")) {}
 
     const char* what() const noexcept override {
         return full_msg.c_str();
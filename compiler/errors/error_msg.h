@@ -4,13 +4,16 @@
 #include "location.h"
 #include "source_file.h"
 
+// Line and column are decoded here, so compiles without errors never compute them
 inline std::string token_message(const Location& loc, const std::string& message) {
-    const std::string& filename = loc.src->filename;
-    const std::string prefix = filename + ":" + std::to_string(loc.start.line) + ":" +
-                               std::to_string(loc.start.column) + ": " + message + "\n";
-    const std::string codeLine = " " + std::to_string(loc.start.line) + " | " + loc.src->get_line(loc.start.line);
-    const std::string pointer  = std::string(std::to_string(loc.start.line).length(), ' ')
-                                + "  | " + std::string(loc.start.column -1, ' ')
-                                + std::string(loc.end.column - loc.start.column, '^')  + "\n";
+    const SourceFile& src = loc.src();
+    const Position start = loc.start();
+    const std::string line = std::to_string(start.line);
+    const std::string prefix = src.filename + ":" + line + ":" +
+                               std::to_string(start.column) + ": " + message + "\n";
+    const std::string codeLine = " " + line + " | " + std::string(src.get_line(start.line));
+    const std::string pointer  = std::string(line.length(), ' ')
+                                + "  | " + std::string(start.column -1, ' ')
+                                + std::string(loc.length, '^')  + "\n";
     return prefix + codeLine + pointer;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <exception>
 #include <string>
+#include <string_view>
 #include "error_msg.h"
 
 
@@ -8,8 +9,8 @@ class UnknownIdError final : public std::exception {
     std::string full_msg;
 
 public:
-    UnknownIdError(Location location, const std::string& id)
-        : full_msg(token_message(location, "Unknown Identifier: " + id)) {}
+    UnknownIdError(Location location, const std::string_view id)
+        : full_msg(token_message(location, "Unknown Identifier: " + std::string(id))) {}
 
     const char* what() const noexcept override {
         return full_msg.c_str();
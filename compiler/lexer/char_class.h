@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Character classes of the "C" locale, so the lexer doesn't depend on <cctype> and the current locale
+
+enum CharClass : uint8_t {
+    Space  = 1 << 0, // ' ', '\t', '\n', '\v', '\f', '\r'
+    Blank  = 1 << 1, // Space without '\n'
+    Digit  = 1 << 2,
+    Alpha  = 1 << 3,
+    IdChar = 1 << 4, // Alpha, Digit and '_'
+    Punct  = 1 << 5,
+};
+
+inline constexpr std::array<uint8_t, 256> char_classes = [] {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; c++) {
+        uint8_t cls = 0;
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            cls |= Space;
+            if (c != '\n') {
+                cls |= Blank;
+            }
+        }
+        if (c >= '0' && c <= '9') {
+            cls |= Digit | IdChar;
+        }
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            cls |= Alpha | IdChar;
+        }
+        if (c == '_') {
+            cls |= IdChar;
+        }
+        if (c > ' ' && c < 127 && !(cls & (Alpha | Digit))) {
+            cls |= Punct;
+        }
+        table[c] = cls;
+    }
+    return table;
+}();
+
+constexpr bool has_class(const char c, const uint8_t cls) {
+    return char_classes[static_cast<unsigned char>(c)] & cls;
+}
+
+constexpr bool is_space(const char c) { return has_class(c, Space); }
+constexpr bool is_blank(const char c) { return has_class(c, Blank); }
+constexpr bool is_digit(const char c) { return has_class(c, Digit); }
+constexpr bool is_alpha(const char c) { return has_class(c, Alpha); }
+constexpr bool is_id_char(const char c) { return has_class(c, IdChar); }
+constexpr bool is_punct(const char c) { return has_class(c, Punct); }
+
+static_assert(is_punct('_') && is_id_char('_') && !is_alpha('_'));
+static_assert(is_blank('\t') && !is_blank('\n') && is_space('\n'));
+static_assert(!is_alpha(static_cast<char>(0xE4)));
@@ -0,0 +1,169 @@
+#include "interner.h"
+
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Mixes in eight bytes at a time, identifiers are short and this sits on the lexer's hot path
+static uint32_t hash_name(const std::string_view name) {
+    constexpr uint64_t k = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = name.size() * k;
+    const char* p = name.data();
+    size_t left = name.size();
+    for (; left >= 8; p += 8, left -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        hash = std::rotl((hash ^ word) * k, 29);
+    }
+    if (left > 0) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < left; i++) {
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        hash = std::rotl((hash ^ word) * k, 29);
+    }
+    hash *= k;
+    return static_cast<uint32_t>(hash >> 32);
+}
+
+namespace {
+
+// Open addressing with linear probing. A slot keeps the full hash next to the id, so most
+// mismatches are rejected without touching the name.
+struct Interner {
+    struct Slot {
+        uint32_t hash;
+        uint32_t id;
+    };
+    static constexpr uint32_t empty = 0;
+
+    std::shared_mutex mutex;
+    // A deque never moves its elements, so the views into them stay valid
+    std::deque<std::string> names;
+    std::vector<Slot> slots = std::vector<Slot>(1024);
+
+    Interner() {
+        // Id 0 is the empty string, which marks a free slot and is never looked up
+        names.emplace_back();
+    }
+
+    Slot* find(const std::string_view name, const uint32_t hash) {
+        const size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (slot.id == empty || (slot.hash == hash && names[slot.id] == name)) {
+                return &slot;
+            }
+        }
+    }
+
+    uint32_t add(const std::string_view name, const uint32_t hash) {
+        if ((names.size() + 1) * 2 > slots.size()) {
+            grow();
+        }
+        const auto id = static_cast<uint32_t>(names.size());
+        names.emplace_back(name);
+        *find(name, hash) = {hash, id};
+        return id;
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        const size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.id == empty) {
+                continue;
+            }
+            size_t i = slot.hash & mask;
+            while (slots[i].id != empty) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+};
+
+Interner& interner() {
+    static Interner instance;
+    return instance;
+}
+
+// The id of name together with the interner's copy of it
+std::pair<uint32_t, std::string_view> find_or_add(const std::string_view name, const uint32_t hash) {
+    if (name.empty()) {
+        return {0, {}};
+    }
+    auto& in = interner();
+    {
+        std::shared_lock lock(in.mutex);
+        if (const auto* slot = in.find(name, hash); slot->id != Interner::empty) {
+            return {slot->id, in.names[slot->id]};
+        }
+    }
+    std::unique_lock lock(in.mutex);
+    if (const auto* slot = in.find(name, hash); slot->id != Interner::empty) {
+        return {slot->id, in.names[slot->id]};
+    }
+    const uint32_t id = in.add(name, hash);
+    return {id, in.names.back()};
+}
+
+}
+
+Ident intern(const std::string_view name) {
+    return {find_or_add(name, hash_name(name)).first};
+}
+
+Ident IdentCache::intern(const std::string_view name) {
+    const uint32_t hash = hash_name(name);
+    const size_t mask = entries.size() - 1;
+    size_t i = hash & mask;
+    for (; !entries[i].name.empty(); i = (i + 1) & mask) {
+        if (entries[i].hash == hash && entries[i].name == name) {
+            return entries[i].ident;
+        }
+    }
+    const auto [id, stored] = find_or_add(name, hash);
+    if (stored.empty()) {
+        return {id};
+    }
+    entries[i] = {stored, hash, {id}};
+    if (++used * 2 > entries.size()) {
+        grow();
+    }
+    return {id};
+}
+
+void IdentCache::grow() {
+    std::vector<Entry> old(entries.size() * 2);
+    old.swap(entries);
+    const size_t mask = entries.size() - 1;
+    for (const Entry& entry : old) {
+        if (entry.name.empty()) {
+            continue;
+        }
+        size_t i = entry.hash & mask;
+        while (!entries[i].name.empty()) {
+            i = (i + 1) & mask;
+        }
+        entries[i] = entry;
+    }
+}
+
+std::string_view Ident::str() const {
+    auto& in = interner();
+    std::shared_lock lock(in.mutex);
+    return in.names[id];
+}
+
+uint32_t interned_count() {
+    auto& in = interner();
+    std::shared_lock lock(in.mutex);
+    return static_cast<uint32_t>(in.names.size());
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// An interned identifier. Equal names get the same dense id, so identifiers are compared and
+// hashed as integers and each name is stored once for the whole process.
+struct Ident {
+    uint32_t id = 0;
+
+    // Valid for the lifetime of the process
+    std::string_view str() const;
+
+    bool operator==(const Ident&) const = default;
+};
+
+template<>
+struct std::hash<Ident> {
+    size_t operator()(const Ident ident) const noexcept { return ident.id; }
+};
+
+// Safe to call from any thread. The empty string is always id 0
+Ident intern(std::string_view name);
+
+// Remembers the names a lexer has already interned, so identifiers that repeat within a file
+// skip the interner's lock. Not thread-safe, every lexer has its own.
+class IdentCache {
+public:
+    Ident intern(std::string_view name);
+
+private:
+    struct Entry {
+        // Points into the interner's storage, empty for a free slot
+        std::string_view name;
+        uint32_t hash = 0;
+        Ident ident;
+    };
+    std::vector<Entry> entries = std::vector<Entry>(256);
+    size_t used = 0;
+
+    void grow();
+};
+
+// Number of distinct identifiers interned so far
+uint32_t interned_count();
+
+// Names the compiler itself refers to
+inline const Ident main_ident = intern("main");
+inline const Ident printf_ident = intern("printf");
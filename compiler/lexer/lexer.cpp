@@ -1,45 +1,52 @@
+#include <cstring>
 #include <string>
 #include "lexer.h"
+#include "char_class.h"
+#include "scan.h"
 #include "source_file.h"
 #include "token.h"
 #include "token_type.h"
 #include "syntax_error.h"
 
-Lexer::Lexer(SourceFile &src)
-    : src(src), cur_line(&src.get_line(1)){
+Lexer::Lexer(SourceFile &src, const LexMode mode)
+    : src(src), scan(mode == LexMode::Simd ? simd_scanner() : scalar_scanner()),
+    begin(src.text().data()), cur(begin), end(begin + src.text().size()) {
 }
 
 Token Lexer::advance() {
     while (true) {
         const char c = peek();
         if (c == '\0') {
-            get_char();
-            return {TokenType::Eof, "", get_loc_col(column)};
+            return {TokenType::Eof, "", loc_from(cur)};
         }
 
         if (c == '#') {
-            const int co = static_cast<int>(cur_line->size());
-            const Location location{src, line,co,co};
-            line++;
-            column = 0;
+            cur = static_cast<const char*>(std::memchr(cur, '\n', end - cur));
+            const Location location = loc_from(cur);
+            cur++;
             return {TokenType::Newline, "", location};
         }
 
 
-        if (std::isspace(c)) {
-            const int start_col = column;
+        if (c == '\n') {
+            const char* start = cur;
             get_char();
-            if (c == '\n' && paren_count == 0) {
-                return {TokenType::Newline, "\n", get_loc_col(start_col)};
+            if (paren_count == 0) {
+                return {TokenType::Newline, "\n", loc_from(start)};
             }
             continue;
         }
 
-        if (std::isdigit(c)) {
+        if (is_blank(c)) {
+            cur = scan.skip_blanks(cur, end);
+            continue;
+        }
+
+        if (is_digit(c)) {
             return lex_number();
         }
 
-        if (std::isalpha(c)) {
+        if (is_alpha(c)) {
             return lex_identifier();
         }
 
@@ -51,139 +58,131 @@ Token Lexer::advance() {
             return lex_string();
         }
 
-        if (std::ispunct(c)) {
-            return lex_symbol();
-        }
+        // Reports unknown characters
+        return lex_symbol();
     }
 }
 
 char Lexer::peek() const {
-    if (column > cur_line->size()) {
-        if (line + 1 > src.length()) {
-            return '\0';
-        }
-        return src.get_line(line+1)[0];
-    }
-    return (*cur_line)[column-1];
+    return cur == end ? '\0' : *cur;
 }
 
-Location Lexer::get_loc_col(int start_col) const {
-    // Ensures token at the beginning of a line have start_col = 1
-    start_col = column < start_col ? 1 : start_col;
-    return {src, line, start_col, column};
+Location Lexer::loc_from(const char* start) const {
+    return {src, static_cast<size_t>(start - begin), static_cast<size_t>(cur - start)};
 }
 
 char Lexer::get_char() {
-    if (column > cur_line->size()) {
-        column = 1;
-        line++;
-        if (line > src.length()) {
-            return '\0';
-        }
-        cur_line = &src.get_line(line);
+    if (cur == end) {
+        return '\0';
     }
-    return (*cur_line)[column++ -1];
+    return *cur++;
 }
 
 void Lexer::log_syntax_error(const std::string &msg) const {
-    throw SyntaxError(msg, {get_loc_col(column)});
+    throw SyntaxError(msg, loc_from(cur));
 }
 
 
 Token Lexer::lex_number() {
-    const int col_start = column;
-    std::string lexeme;
+    const char* start = cur;
     auto t = TokenType::IntConst;
-    while (std::isdigit(peek())) {
-        lexeme += get_char();
-    }
+    get_char();
+    cur = scan.skip_digits(cur, end);
     if (peek() == '.') {
         t = TokenType::FloatConst;
-        do {
-            lexeme += get_char();
-        } while (std::isdigit(peek()));
+        get_char();
+        cur = scan.skip_digits(cur, end);
     }
-    return {t, lexeme, get_loc_col(col_start)};
+    return {t, {start, static_cast<size_t>(cur - start)}, loc_from(start)};
 }
 
 Token Lexer::lex_identifier() {
-    const int col_start = column;
-    std::string lexeme;
-    do {
-        lexeme += get_char();
-    } while (std::isalnum(peek()) || peek() == '_');
-    const auto t = is_keyword(lexeme) ? keywords.at(lexeme) : TokenType::Id;
-    return {t, t == TokenType::Id ? lexeme : "",get_loc_col(col_start)};
+    const char* start = cur;
+    get_char();
+    cur = scan.skip_id_chars(cur, end);
+    const std::string_view lexeme(start, cur - start);
+    const auto t = keyword_type(lexeme);
+    if (t != TokenType::Id) {
+        return {t, "", loc_from(start)};
+    }
+    return {t, lexeme, loc_from(start), idents.intern(lexeme)};
 }
 
-static const std::unordered_map<char, std::string> escapeSequences = {
-    {'n',  "\n"},
-    {'t',  "\t"},
-    {'r',  "\r"},
-    {'\'', "\'"},
-    {'\"', "\""},
-    {'\\', "\\"},
-    {'0',  "\0"},
-    {'b',  "\b"},
-    {'f',  "\f"},
-    {'v',  "\v"}
-};
+// The character after a '\' and the character it stands for share the same index
+static constexpr std::string_view escape_chars = "ntr\'\"\\0bfv";
+static constexpr std::string_view escape_values{"\n\t\r\'\"\\\0\b\f\v", 10};
+
+static std::string_view unescape(const char c) {
+    const auto i = escape_chars.find(c);
+    return i == std::string_view::npos ? std::string_view{} : escape_values.substr(i, 1);
+}
 
 Token Lexer::lex_char() {
-    const int start_col = column;
+    const char* start = cur;
     get_char(); // '
     const char c = peek();
 
     if (c == '\n') {
         log_syntax_error("Unterminated char literal");
     }
-    std::string lexeme;
+    std::string_view lexeme;
     if (c == '\\') {
         get_char();
-        if (escapeSequences.contains(peek())) {
-            lexeme += escapeSequences.at(get_char());
-        } else {
+        lexeme = unescape(peek());
+        if (lexeme.empty()) {
             log_syntax_error("Unknown escape character");
         }
+        get_char();
     } else if (c == '\'') {
         log_syntax_error("empty char literal");
     } else {
-        lexeme += get_char();
+        lexeme = {cur, 1};
+        get_char();
     }
     get_char(); // '
-    return {TokenType::CharConst, lexeme, get_loc_col(start_col)};
+    return {TokenType::CharConst, lexeme, loc_from(start)};
 }
 
 Token Lexer::lex_string() {
-    const int start_col = column;
+    const char* start = cur;
     get_char(); // "
-    std::string lexeme;
-    while (peek() != '\"') {
-        const char c = peek();
+    const char* body = cur;
+    cur = scan.skip_string_body(cur, end);
+    if (peek() == '\n') {
+        log_syntax_error("Unterminated string literal");
+    }
+    std::string_view lexeme(body, cur - body);
 
-        if (c == '\n') {
-            log_syntax_error("Unterminated string literal");
-        }
-        if (c == '\\') {
+    // Only literals with escape sequences need their own storage
+    if (peek() == '\\') {
+        std::string& unescaped = escaped_literals.emplace_back(lexeme);
+        while (peek() != '\"') {
+            const char c = peek();
+
+            if (c == '\n') {
+                log_syntax_error("Unterminated string literal");
+            }
             get_char();
-            if (escapeSequences.contains(peek())) {
-                lexeme += escapeSequences.at(get_char());
+            if (c == '\\') {
+                const auto escaped = unescape(peek());
+                if (escaped.empty()) {
+                    log_syntax_error("Unknown escape character");
+                }
+                get_char();
+                unescaped += escaped;
                 continue;
             }
-            log_syntax_error("Unknown escape character");
-        } else {
-            get_char();
+            unescaped += c;
         }
-
-        lexeme += c;
+        lexeme = unescaped;
     }
     get_char(); // "
-    return {TokenType::StringConst, lexeme, get_loc_col(start_col)};
+    return {TokenType::StringConst, lexeme, loc_from(start)};
 }
 
 
 Token Lexer::lex_symbol() {
-    const int start_col = column;
+    const char* start = cur;
     char c = get_char();
     using enum TokenType;
     auto type = Error;
@@ -232,5 +231,5 @@ Token Lexer::lex_symbol() {
         default: log_syntax_error("Unknown symbol");
 
     }
-    return {type, "", get_loc_col(start_col)};
+    return {type, "", loc_from(start)};
 }
@@ -1,28 +1,48 @@
 #pragma once
+#include <deque>
+#include <string>
+
+#include "interner.h"
 
 
 struct Location;
+struct Scanner;
 struct SourceFile;
 struct Token;
 
+// Both modes produce the same tokens. Simd scans runs of identifier characters, digits,
+// whitespace and string bodies 16 or 32 bytes at a time
+enum class LexMode {Scalar, Simd};
+
 class Lexer {
 public:
-    explicit Lexer(SourceFile& src);
+    explicit Lexer(SourceFile& src, LexMode mode = LexMode::Simd);
 
     Token advance();
 
 private:
-    int line = 1;
-    int column = 1;
     int paren_count = 0;
     SourceFile& src;
-    std::string* cur_line;
+    const Scanner& scan;
+
+    // Unescaped contents of string literals with escape sequences.
+    // All other lexemes point directly into the source buffer
+    std::deque<std::string> escaped_literals;
+
+    IdentCache idents;
+
+    // Cursor into the source buffer, which always ends with '\n'.
+    // Lines and columns aren't tracked, locations only record offsets.
+    const char* begin;
+    const char* cur;
+    const char* end;
 
     char peek() const;
     char get_char();
 
     void log_syntax_error(const std::string& msg) const;
-    Location get_loc_col(int start_col) const;
+    // From start up to the cursor
+    Location loc_from(const char* start) const;
 
     Token lex_number();
     Token lex_identifier();
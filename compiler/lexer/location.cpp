@@ -3,7 +3,30 @@
 
 #include "source_file.h"
 
+Location::Location(const SourceFile& src, const size_t offset, const size_t length)
+    : pos(src.base + static_cast<uint32_t>(offset)), length(static_cast<uint32_t>(length)) {}
+
+SourceFile& Location::src() const {
+    return SourceFile::containing(pos);
+}
+
+size_t Location::offset() const {
+    return pos - src().base;
+}
+
+Position Location::start() const {
+    const SourceFile& file = src();
+    return file.position(pos - file.base);
+}
+
+Position Location::end() const {
+    const Position s = start();
+    return {s.line, s.column + static_cast<int>(length)};
+}
+
 std::string Location::to_string() const {
-    return src->filename + ":: " + std::to_string(start.line) + ":" + std::to_string(start.column)
-    + " - " + std::to_string(end.line) + ":" +  std::to_string(end.column);
-}
\ No newline at end of file
+    const Position s = start();
+    const Position e = end();
+    return src().filename + ":: " + std::to_string(s.line) + ":" + std::to_string(s.column)
+    + " - " + std::to_string(e.line) + ":" +  std::to_string(e.column);
+}
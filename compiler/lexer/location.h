@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 
@@ -13,13 +14,25 @@ struct Position {
     }
 };
 
+// Every source file owns a range of one global offset space (see SourceFile::base), so a
+// location is just a global offset and a length. Line and column are only computed when
+// they are needed, usually to report an error.
 struct Location {
-    SourceFile* src;
-    Position start;
-    Position end;
+    uint32_t pos;
+    uint32_t length;
+
+    // offset is relative to the start of src
+    Location(const SourceFile& src, size_t offset, size_t length);
+
+    SourceFile& src() const;
+    // Offset relative to the start of the file
+    size_t offset() const;
+
+    Position start() const;
+    // The column after the last character, on the line of start
+    Position end() const;
 
     std::string to_string() const;
+};
 
-    Location(SourceFile& src, int line, int start_col, int end_col)
-        : src(&src), start({line, start_col}), end({line, end_col}) {}
-};
\ No newline at end of file
+static_assert(sizeof(Location) == 8);
@@ -0,0 +1,173 @@
+#include "scan.h"
+
+#include "char_class.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ARCO_X86_SIMD 1
+#endif
+
+constexpr bool in_string_body(const char c) {
+    return c != '"' && c != '\\' && c != '\n';
+}
+
+template<bool (*in_run)(char)>
+static const char* skip_scalar(const char* p, const char* const end) {
+    while (p != end && in_run(*p)) {
+        p++;
+    }
+    return p;
+}
+
+static constexpr Scanner scalar{
+    "scalar",
+    skip_scalar<is_id_char>,
+    skip_scalar<is_digit>,
+    skip_scalar<is_blank>,
+    skip_scalar<in_string_body>,
+};
+
+const Scanner& scalar_scanner() {
+    return scalar;
+}
+
+#ifdef ARCO_X86_SIMD
+
+// Every block function returns a bitmask with one bit per byte that is part of the run.
+// The run ends at the first zero bit, the remaining tail is handled by the scalar version.
+
+// Most runs are only a few bytes long, so the first bytes are checked one at a time
+// before switching to vectors
+constexpr int scalar_prologue = 8;
+
+template<bool (*in_run)(char)>
+static bool skip_prologue(const char*& p, const char* const end) {
+    for (int i = 0; i < scalar_prologue; i++, p++) {
+        if (p == end || !in_run(*p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// lo <= c <= hi, as unsigned bytes
+static __m128i in_range_128(const __m128i c, const char lo, const char hi) {
+    const __m128i shifted = _mm_sub_epi8(c, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+static unsigned id_chars_128(const __m128i c) {
+    const __m128i letter = in_range_128(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z');
+    const __m128i digit = in_range_128(c, '0', '9');
+    const __m128i underscore = _mm_cmpeq_epi8(c, _mm_set1_epi8('_'));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore));
+}
+
+static unsigned digits_128(const __m128i c) {
+    return _mm_movemask_epi8(in_range_128(c, '0', '9'));
+}
+
+static unsigned blanks_128(const __m128i c) {
+    const __m128i space = _mm_cmpeq_epi8(c, _mm_set1_epi8(' '));
+    const __m128i control = in_range_128(c, '\t', '\r');
+    const __m128i newline = _mm_cmpeq_epi8(c, _mm_set1_epi8('\n'));
+    return _mm_movemask_epi8(_mm_or_si128(space, _mm_andnot_si128(newline, control)));
+}
+
+static unsigned string_body_128(const __m128i c) {
+    const __m128i quote = _mm_cmpeq_epi8(c, _mm_set1_epi8('"'));
+    const __m128i backslash = _mm_cmpeq_epi8(c, _mm_set1_epi8('\\'));
+    const __m128i newline = _mm_cmpeq_epi8(c, _mm_set1_epi8('\n'));
+    return ~_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(quote, backslash), newline)) & 0xFFFF;
+}
+
+template<unsigned (*block)(__m128i), bool (*in_run)(char)>
+static const char* skip_sse2(const char* p, const char* const end) {
+    if (skip_prologue<in_run>(p, end)) {
+        return p;
+    }
+    while (end - p >= 16) {
+        const unsigned mask = block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if (mask != 0xFFFF) {
+            return p + __builtin_ctz(~mask);
+        }
+        p += 16;
+    }
+    return skip_scalar<in_run>(p, end);
+}
+
+static constexpr Scanner sse2{
+    "sse2",
+    skip_sse2<id_chars_128, is_id_char>,
+    skip_sse2<digits_128, is_digit>,
+    skip_sse2<blanks_128, is_blank>,
+    skip_sse2<string_body_128, in_string_body>,
+};
+
+#define ARCO_AVX2 __attribute__((target("avx2")))
+
+ARCO_AVX2 static __m256i in_range_256(const __m256i c, const char lo, const char hi) {
+    const __m256i shifted = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+ARCO_AVX2 static unsigned id_chars_256(const __m256i c) {
+    const __m256i letter = in_range_256(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 'z');
+    const __m256i digit = in_range_256(c, '0', '9');
+    const __m256i underscore = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_'));
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter, digit), underscore));
+}
+
+ARCO_AVX2 static unsigned digits_256(const __m256i c) {
+    return _mm256_movemask_epi8(in_range_256(c, '0', '9'));
+}
+
+ARCO_AVX2 static unsigned blanks_256(const __m256i c) {
+    const __m256i space = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(' '));
+    const __m256i control = in_range_256(c, '\t', '\r');
+    const __m256i newline = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n'));
+    return _mm256_movemask_epi8(_mm256_or_si256(space, _mm256_andnot_si256(newline, control)));
+}
+
+ARCO_AVX2 static unsigned string_body_256(const __m256i c) {
+    const __m256i quote = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('"'));
+    const __m256i backslash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\\'));
+    const __m256i newline = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n'));
+    return ~_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(quote, backslash), newline));
+}
+
+template<unsigned (*block)(__m256i), bool (*in_run)(char)>
+ARCO_AVX2 static const char* skip_avx2(const char* p, const char* const end) {
+    if (skip_prologue<in_run>(p, end)) {
+        return p;
+    }
+    while (end - p >= 32) {
+        const unsigned mask = block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if (mask != 0xFFFFFFFF) {
+            return p + __builtin_ctz(~mask);
+        }
+        p += 32;
+    }
+    return skip_scalar<in_run>(p, end);
+}
+
+static constexpr Scanner avx2{
+    "avx2",
+    skip_avx2<id_chars_256, is_id_char>,
+    skip_avx2<digits_256, is_digit>,
+    skip_avx2<blanks_256, is_blank>,
+    skip_avx2<string_body_256, in_string_body>,
+};
+
+const Scanner& simd_scanner() {
+    static const Scanner& best = __builtin_cpu_supports("avx2") ? avx2 : sse2;
+    return best;
+}
+
+#else
+
+const Scanner& simd_scanner() {
+    return scalar;
+}
+
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+// Functions that skip runs of characters in the source buffer.
+// Each one returns the first position in [p, end) that isn't part of the run, or end.
+struct Scanner {
+    const char* name;
+    // [A-Za-z0-9_]
+    const char* (*skip_id_chars)(const char* p, const char* end);
+    // [0-9]
+    const char* (*skip_digits)(const char* p, const char* end);
+    // Whitespace except '\n', which is significant for the parser
+    const char* (*skip_blanks)(const char* p, const char* end);
+    // Stops at '"', '\\' and '\n'
+    const char* (*skip_string_body)(const char* p, const char* end);
+};
+
+// One character at a time, available on every platform
+const Scanner& scalar_scanner();
+
+// The widest vectorized scanner supported by the host (AVX2, SSE2), chosen once at runtime.
+// Falls back to the scalar scanner on other architectures
+const Scanner& simd_scanner();
@@ -3,5 +3,5 @@
 #include "token_type.h"
 
 std::string Token::to_string() const {
-    return loc.to_string() + ":: " + str_of_type(type) + " " + lexeme;
+    return loc.to_string() + ":: " + str_of_type(type) + " " + std::string(lexeme);
 }
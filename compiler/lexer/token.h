@@ -1,15 +1,21 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 
+#include "interner.h"
 #include "location.h"
 
 
-enum class TokenType;
+enum class TokenType : uint8_t;
 
 struct Token {
     TokenType type;
-    std::string lexeme;
+    // Points into the source buffer or into the lexer's storage for escaped literals
+    std::string_view lexeme;
     Location loc;
+    // Only set for identifiers
+    Ident ident;
 
     std::string to_string() const;
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "token_buffer.h"
+
+#include "source_file.h"
+#include "syntax_error.h"
+#include "token_type.h"
+
+TokenBuffer::TokenBuffer(SourceFile &src, const LexMode mode)
+    : src(src) {
+    // Generated code averages around five bytes per token
+    const size_t expected = src.text().size() / 5 + 1;
+    types.reserve(expected);
+    offsets.reserve(expected);
+    lengths.reserve(expected);
+    idents.reserve(expected);
+
+    Lexer lexer(src, mode);
+    try {
+        while (true) {
+            const Token tok = lexer.advance();
+            push(tok);
+            if (tok.type == TokenType::Eof) {
+                break;
+            }
+        }
+    } catch (const SyntaxError&) {
+        error = std::current_exception();
+        types.push_back(TokenType::Error);
+        offsets.push_back(static_cast<uint32_t>(src.text().size()));
+        lengths.push_back(0);
+        idents.emplace_back();
+    }
+}
+
+void TokenBuffer::push(const Token &tok) {
+    const auto i = static_cast<uint32_t>(types.size());
+    types.push_back(tok.type);
+    offsets.push_back(tok.loc.pos - src.base);
+    lengths.push_back(tok.loc.length);
+    idents.push_back(tok.ident);
+
+    if (tok.type == TokenType::StringConst || tok.type == TokenType::CharConst) {
+        if (lexeme(i).data() != tok.lexeme.data()) {
+            escaped.emplace(i, tok.lexeme);
+        }
+    }
+}
+
+std::string_view TokenBuffer::lexeme(size_t i) const {
+    i = clamp(i);
+    const auto text = src.text().substr(offsets[i], lengths[i]);
+    switch (types[i]) {
+        case TokenType::Id:
+        case TokenType::IntConst:
+        case TokenType::FloatConst:
+        case TokenType::Newline:
+            return text;
+        case TokenType::StringConst:
+        case TokenType::CharConst:
+            if (const auto it = escaped.find(i); it != escaped.end()) {
+                return it->second;
+            }
+            return text.substr(1, text.size() - 2);
+        default:
+            return "";
+    }
+}
+
+Token TokenBuffer::get(size_t i) const {
+    i = clamp(i);
+    return {types[i], lexeme(i), {src, offsets[i], lengths[i]}, idents[i]};
+}
+
+void TokenBuffer::rethrow_error() const {
+    std::rethrow_exception(error);
+}
+
+size_t TokenBuffer::bytes() const {
+    size_t total = types.capacity() * sizeof(TokenType) + offsets.capacity() * sizeof(uint32_t)
+                   + lengths.capacity() * sizeof(uint32_t) + idents.capacity() * sizeof(Ident);
+    for (const auto& [_, lexeme] : escaped) {
+        total += sizeof(std::pair<const uint32_t, std::string>) + lexeme.capacity();
+    }
+    return total;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "lexer.h"
+#include "token.h"
+
+struct SourceFile;
+
+// All tokens of a file, lexed up front and stored as a structure of arrays.
+// Tokens are addressed by their index, so the parser can look ahead and backtrack freely.
+struct TokenBuffer {
+    SourceFile& src;
+
+    explicit TokenBuffer(SourceFile& src, LexMode mode = LexMode::Simd);
+
+    size_t size() const { return types.size(); }
+
+    // Indices past the end refer to the final Eof (or Error) token
+    TokenType type(size_t i) const { return types[clamp(i)]; }
+    std::string_view lexeme(size_t i) const;
+    Token get(size_t i) const;
+
+    // Heap memory held by the buffer
+    size_t bytes() const;
+
+    // The lexer stops at the first syntax error and records it as an Error token
+    [[noreturn]] void rethrow_error() const;
+
+private:
+    std::vector<TokenType> types;
+    // Byte offset and length of each token in the source buffer
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    // Only meaningful for identifiers
+    std::vector<Ident> idents;
+    // Char and string literals whose lexeme isn't the text between their quotes
+    std::unordered_map<uint32_t, std::string> escaped;
+    std::exception_ptr error;
+
+    size_t clamp(const size_t i) const { return i < types.size() ? i : types.size() - 1; }
+    void push(const Token& tok);
+};
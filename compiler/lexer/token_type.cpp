@@ -1,4 +1,6 @@
+#include <iterator>
 #include <string>
+#include <string_view>
 #include "token_type.h"
 
 using enum TokenType;
@@ -16,6 +18,7 @@ std::string str_of_type(TokenType type) {
         case Fun:          return "fun";
         case Internal:     return "internal";
         case External:     return "external";
+        case Import:       return "import";
         case Of:           return "of";
         case True:         return "true";
         case False:        return "false";
@@ -27,6 +30,7 @@ std::string str_of_type(TokenType type) {
         case Char:         return "char";
         case String:       return "string";
         case Unit:         return "unit";
+        case Bool:         return "bool";
         case If:           return "if";
         case Then:         return "then";
         case Else:         return "else";
@@ -64,6 +68,107 @@ std::string str_of_type(TokenType type) {
     }
 }
 
-bool is_keyword(const std::string & lexeme) {
-    return keywords.contains(lexeme);
+namespace {
+
+struct Keyword {
+    std::string_view lexeme;
+    TokenType type;
+};
+
+constexpr Keyword keyword_list[] = {
+    {"var", Var},
+    {"let", Let},
+    {"fun", Fun},
+    {"internal", Internal},
+    {"external", External},
+    {"import", Import},
+    {"of", Of},
+    {"true", True},
+    {"false", False},
+    {"and", And},
+    {"or", Or},
+    {"not", Not},
+    {"int", Int},
+    {"float", Float},
+    {"char", Char},
+    {"string", String},
+    {"bool", Bool},
+    {"unit", Unit},
+    {"if", If},
+    {"then", Then},
+    {"else", Else},
+    {"while", While},
+};
+
+constexpr size_t min_keyword_length = 2;
+constexpr size_t max_keyword_length = 8;
+constexpr unsigned keyword_table_bits = 7;
+
+// Only looks at the length, the first and the last character
+constexpr unsigned keyword_hash(const std::string_view word, const unsigned seed) {
+    const unsigned mixed = (static_cast<unsigned char>(word.front()) * 0x9E3779B1u)
+                           ^ (static_cast<unsigned char>(word.back()) * seed)
+                           ^ static_cast<unsigned>(word.size());
+    return (mixed * seed) >> (32 - keyword_table_bits);
+}
+
+// The first seed for which keyword_hash has no collisions on the keyword set
+constexpr unsigned keyword_seed = [] {
+    for (unsigned seed = 1;; seed += 2) {
+        bool used[1 << keyword_table_bits] = {};
+        bool perfect = true;
+        for (const auto& [lexeme, _] : keyword_list) {
+            const unsigned h = keyword_hash(lexeme, seed);
+            perfect = perfect && !used[h];
+            used[h] = true;
+        }
+        if (perfect) {
+            return seed;
+        }
+    }
+}();
+
+struct KeywordTable {
+    Keyword slots[1 << keyword_table_bits];
+};
+
+constexpr KeywordTable keyword_table = [] {
+    KeywordTable table{};
+    for (auto& slot : table.slots) {
+        slot = {"", Id};
+    }
+    for (const auto& kw : keyword_list) {
+        table.slots[keyword_hash(kw.lexeme, keyword_seed)] = kw;
+    }
+    return table;
+}();
+
+// One hash and one compare
+constexpr TokenType lookup_keyword(const std::string_view word) {
+    if (word.size() < min_keyword_length || word.size() > max_keyword_length) {
+        return Id;
+    }
+    const auto& [lexeme, type] = keyword_table.slots[keyword_hash(word, keyword_seed)];
+    return lexeme == word ? type : Id;
+}
+
+static_assert([] {
+    for (const auto& [lexeme, type] : keyword_list) {
+        if (lookup_keyword(lexeme) != type) {
+            return false;
+        }
+    }
+    return lookup_keyword("x") == Id && lookup_keyword("whilst") == Id && lookup_keyword("internals") == Id;
+}());
+
+static_assert(std::size(keyword_list) == static_cast<size_t>(last_keyword) - static_cast<size_t>(first_keyword) + 1);
+
+}
+
+TokenType keyword_type(const std::string_view lexeme) {
+    return lookup_keyword(lexeme);
+}
+
+bool is_keyword(const std::string_view lexeme) {
+    return lookup_keyword(lexeme) != Id;
 }
@@ -1,15 +1,19 @@
 #pragma once
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
-enum class TokenType;
+enum class TokenType : uint8_t;
 
 std::string str_of_type(TokenType);
 
-bool is_keyword(const std::string&);
+bool is_keyword(std::string_view);
 
+// The keyword spelled by lexeme, or TokenType::Id
+TokenType keyword_type(std::string_view lexeme);
 
-enum class TokenType {
+
+enum class TokenType : uint8_t {
     Id,
     IntConst,
     FloatConst,
@@ -19,6 +23,7 @@ enum class TokenType {
     // Keywords
     Internal,
     External,
+    Import,
     Var,
     Let,
     Fun,
@@ -73,26 +78,6 @@ enum class TokenType {
     Error,
 };
 
-inline std::unordered_map<std::string, TokenType> keywords = {
-    {"var", TokenType::Var},
-    {"let", TokenType::Let},
-    {"fun", TokenType::Fun},
-    {"internal", TokenType::Internal},
-    {"external", TokenType::External},
-    {"of", TokenType::Of},
-    {"true", TokenType::True},
-    {"false", TokenType::False},
-    {"and", TokenType::And},
-    {"or", TokenType::Or},
-    {"not", TokenType::Not},
-    {"int",   TokenType::Int},
-    {"float", TokenType::Float},
-    {"char",  TokenType::Char},
-    {"string",TokenType::String},
-    {"bool", TokenType::Bool},
-    {"unit", TokenType::Unit},
-    {"if", TokenType::If},
-    {"then", TokenType::Then},
-    {"else", TokenType::Else},
-    {"while", TokenType::While}
-};;
\ No newline at end of file
+// Every keyword lies in [first_keyword, last_keyword]
+constexpr TokenType first_keyword = TokenType::Internal;
+constexpr TokenType last_keyword = TokenType::While;
@@ -99,7 +99,7 @@ ExprPtr Parser::parse_binary_expr(const int precedence, ExprPtr lhs) {
             rhs = parse_binary_expr(tok_prec + 1, std::move(rhs));
         }
 
-        lhs = std::make_unique<BinaryExpr>(op, std::move(lhs), std::move(rhs));
+        lhs = arena.make<BinaryExpr>(op, std::move(lhs), std::move(rhs));
     }
 }
 
@@ -108,12 +108,12 @@ ExprPtr Parser::parse_constant() {
     auto tok = cur_tok;
     advance();
     switch (tok.type) {
-        case TokenType::IntConst: return std::make_unique<IntConst>(tok);
-        case TokenType::FloatConst: return std::make_unique<FloatConst>(tok);
-        case TokenType::CharConst: return std::make_unique<CharConst>(tok);
-        case TokenType::StringConst: return std::make_unique<StringConst>(tok);
+        case TokenType::IntConst: return arena.make<IntConst>(tok);
+        case TokenType::FloatConst: return arena.make<FloatConst>(tok);
+        case TokenType::CharConst: return arena.make<CharConst>(tok);
+        case TokenType::StringConst: return arena.make<StringConst>(tok, arena);
         case TokenType::True:
-        case TokenType::False: return std::make_unique<BoolConst>(tok);
+        case TokenType::False: return arena.make<BoolConst>(tok);
         // Default case won't happen, already checked by parse_expr()
         default: throw SyntaxError("Invalid constant", tok.loc);
     }
@@ -122,7 +122,7 @@ ExprPtr Parser::parse_constant() {
 ExprPtr Parser::parse_unary_expr() {
     const auto op = cur_tok;
     advance();
-    return std::make_unique<UnaryExpr>(op, parse_expr());
+    return arena.make<UnaryExpr>(op, parse_expr());
 }
 
 ExprPtr Parser::parse_id_expr(std::optional<Token> id) {
@@ -132,24 +132,23 @@ ExprPtr Parser::parse_id_expr(std::optional<Token> id) {
     }
     const auto id_tok = id.value();
     if (cur_tok.type == TokenType::LParen) {
-        return parse_fun_call(id_tok);
+        return parse_fun_call({}, id_tok);
     }
-    return std::make_unique<IdExpr>(id_tok);
-}
-
-ExprPtr Parser::parse_id(const Token& id) {
-    ExprPtr lhs;
-
-    // return parse_binary_expr(0, std::move(lhs));
-    if (cur_tok.type != TokenType::LParen) {
-        return parse_binary_expr(0, std::make_unique<IdExpr>(id));
+    if (cur_tok.type == TokenType::Dot) {
+        advance();
+        const auto callee = cur_tok;
+        expect(TokenType::Id, "Expected a function name after '.'");
+        if (cur_tok.type != TokenType::LParen) {
+            log_error("Only functions can be accessed through a module");
+        }
+        return parse_fun_call(id_tok, callee);
     }
-    return parse_binary_expr(0, parse_fun_call(id));
+    return arena.make<IdExpr>(id_tok);
 }
 
-ExprPtr Parser::parse_fun_call(const Token& id) {
+ExprPtr Parser::parse_fun_call(const std::optional<Token>& qualifier, const Token& id) {
     expect(TokenType::LParen);
-    std::vector<ExprPtr> args;
+    std::pmr::vector<ExprPtr> args(&arena);
     while (cur_tok.type != TokenType::RParen) {
         args.push_back(parse_expr());
 
@@ -159,7 +158,10 @@ ExprPtr Parser::parse_fun_call(const Token& id) {
         expect(TokenType::Comma, "Expected ')' or ','");
     }
     advance();
-    return std::make_unique<FunCall>(id, std::move(args));
+    if (qualifier.has_value()) {
+        return arena.make<FunCall>(qualifier.value(), id, std::move(args));
+    }
+    return arena.make<FunCall>(id, std::move(args));
 }
 
 ExprPtr Parser::parse_paren_expr() {
@@ -167,13 +169,13 @@ ExprPtr Parser::parse_paren_expr() {
     advance();
     auto expr = parse_expr();
     expect(TokenType::RParen);
-    return std::make_unique<ParenExpr>(loc, std::move(expr));
+    return arena.make<ParenExpr>(loc, std::move(expr));
 }
 
 ExprPtr Parser::parse_block_expr() {
     const auto loc = cur_tok.loc;
     advance();
-    std::vector<StmtPtr> body;
+    std::pmr::vector<StmtPtr> body(&arena);
     while (true) {
         skip_new_lines();
         if (cur_tok.type == TokenType::RCurly) {
@@ -183,7 +185,7 @@ ExprPtr Parser::parse_block_expr() {
 
     }
     advance();
-    return std::make_unique<BlockExpr>(loc, std::move(body));
+    return arena.make<BlockExpr>(loc, std::move(body), arena);
 }
 
 ExprPtr Parser::parse_if_else_expr() {
@@ -200,7 +202,7 @@ ExprPtr Parser::parse_if_else_expr() {
         skip_new_lines();
         else_branch.emplace(parse_expr());
     }
-    return std::make_unique<IfElseExpr>(loc, std::move(condition),
+    return arena.make<IfElseExpr>(loc, std::move(condition),
         std::move(if_branch), std::move(else_branch));
 }
 
@@ -212,6 +214,6 @@ ExprPtr Parser::parse_while_expr() {
         log_error("Expected '{'");
     }
     auto body = parse_expr();
-    return std::make_unique<WhileExpr>(loc, std::move(condition), std::move(body));
+    return arena.make<WhileExpr>(loc, std::move(condition), std::move(body));
 }
 
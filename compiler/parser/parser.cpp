@@ -5,8 +5,13 @@
 #include "syntax_error.h"
 #include "token_type.h"
 
-std::vector<StmtPtr> parse_file(SourceFile &src) {
-    Parser p(src);
+std::vector<StmtPtr> parse_file(SourceFile &src, Arena& arena) {
+    const TokenBuffer tokens(src);
+    return parse_file(tokens, arena);
+}
+
+std::vector<StmtPtr> parse_file(const TokenBuffer &tokens, Arena& arena) {
+    Parser p(tokens, arena);
     std::vector<StmtPtr> ast;
     while (true) {
         if (auto node = p.parse_stmt()) {
@@ -18,12 +23,24 @@ std::vector<StmtPtr> parse_file(SourceFile &src) {
     return ast;
 }
 
-Parser::Parser(SourceFile &src)
-    : lexer(src), cur_tok(lexer.advance()) {
+Parser::Parser(SourceFile &src, Arena& arena)
+    : owned_tokens(std::make_unique<TokenBuffer>(src)), tokens(*owned_tokens), arena(arena),
+    cur_tok(token_at(0)) {
+}
+
+Parser::Parser(const TokenBuffer &tokens, Arena& arena)
+    : tokens(tokens), arena(arena), cur_tok(token_at(0)) {
+}
+
+Token Parser::token_at(const size_t i) const {
+    if (tokens.type(i) == TokenType::Error) {
+        tokens.rethrow_error();
+    }
+    return tokens.get(i);
 }
 
 void Parser::advance() {
-    cur_tok = lexer.advance();
+    cur_tok = token_at(++pos);
 }
 
 void Parser::expect(TokenType t) {
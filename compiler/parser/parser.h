@@ -1,29 +1,41 @@
 #pragma once
+#include <memory>
 #include <optional>
 #include <vector>
 
-#include "lexer.h"
 #include "expr.h"
 #include "stmt.h"
 #include "token.h"
+#include "token_buffer.h"
 
 struct DefArg;
 struct FunSignature;
 struct TypeAnno;
 
 
-std::vector<StmtPtr> parse_file(SourceFile& src);
+// The nodes are allocated in the arena, which has to outlive the returned AST
+std::vector<StmtPtr> parse_file(SourceFile& src, Arena& arena);
+
+std::vector<StmtPtr> parse_file(const TokenBuffer& tokens, Arena& arena);
 
 struct Parser {
-    explicit Parser(SourceFile& src);
+    // Tokenizes the whole file up front
+    Parser(SourceFile& src, Arena& arena);
+
+    Parser(const TokenBuffer& tokens, Arena& arena);
 
     StmtPtr parse_stmt();
     ExprPtr parse_expr();
 
 private:
-    Lexer lexer;
+    std::unique_ptr<TokenBuffer> owned_tokens;
+    const TokenBuffer& tokens;
+    Arena& arena;
+    size_t pos = 0;
     Token cur_tok;
 
+    Token token_at(size_t i) const;
+    TokenType peek_type(size_t n) const { return tokens.type(pos + n); }
     void advance();
     void expect(TokenType t);
     void expect(TokenType t, const std::string& msg);
@@ -39,12 +51,13 @@ private:
     StmtPtr parse_var_init(std::optional<Location> loc);
     StmtPtr parse_fun_def(std::optional<Location> loc);
     StmtPtr parse_id_stmt();
-    StmtPtr parse_assignment(Token&);
+    StmtPtr parse_assignment();
     DefArg parse_def_arg();
     FunSignature parse_fun_sig();
     StmtPtr parse_internal_stmt();
     StmtPtr parse_expr_stmt();
     StmtPtr parse_external_stmt();
+    StmtPtr parse_import_stmt();
 
     // Expressions
 
@@ -53,8 +66,8 @@ private:
     ExprPtr parse_unary_expr();
     ExprPtr parse_binary_expr(int precedence, ExprPtr lhs);
     ExprPtr parse_id_expr(std::optional<Token> id);
-    ExprPtr parse_id(const Token& id);
-    ExprPtr parse_fun_call(const Token& id);
+    // qualifier is the module in module.id(...)
+    ExprPtr parse_fun_call(const std::optional<Token>& qualifier, const Token& id);
     ExprPtr parse_paren_expr();
     ExprPtr parse_block_expr();
     ExprPtr parse_if_else_expr();
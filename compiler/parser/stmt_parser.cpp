@@ -16,6 +16,7 @@ StmtPtr Parser::parse_stmt() {
         case Fun: return parse_fun_def({});
         case Id: return parse_id_stmt();
         case External: return parse_external_stmt();
+        case Import: return parse_import_stmt();
         default: return parse_expr_stmt();
     }
 }
@@ -23,22 +24,19 @@ StmtPtr Parser::parse_stmt() {
 
 
 StmtPtr Parser::parse_id_stmt() {
-    auto id = cur_tok;
-    advance();
-    if (cur_tok.type == TokenType::Equal) {
-        return parse_assignment(id);
+    if (peek_type(1) == TokenType::Equal) {
+        return parse_assignment();
     }
-    auto expr = parse_id(id);
-    expect_stmt_end();
-    return std::make_unique<ExprStmt>(expr->loc, std::move(expr));
-
+    return parse_expr_stmt();
 }
 
-StmtPtr Parser::parse_assignment(Token& id) {
+StmtPtr Parser::parse_assignment() {
+    auto id = cur_tok;
+    advance();
     advance();
     auto val = parse_expr();
     expect_stmt_end();
-    return std::make_unique<Assignment>(id, std::move(val));
+    return arena.make<Assignment>(id, std::move(val));
 }
 
 StmtPtr Parser::parse_var_init(std::optional<Location> loc) {
@@ -58,7 +56,7 @@ StmtPtr Parser::parse_var_init(std::optional<Location> loc) {
     expect(TokenType::Equal);
     auto val = parse_expr();
     expect_stmt_end();
-    return std::make_unique<VarInit>(loc.value(), is_internal, is_const, id.lexeme, anno, std::move(val));
+    return arena.make<VarInit>(loc.value(), is_internal, is_const, id.ident, anno, std::move(val));
 }
 
 
@@ -72,7 +70,7 @@ StmtPtr Parser::parse_fun_def(std::optional<Location> loc) {
     expect(TokenType::Equal);
     auto body = parse_expr();
     expect_stmt_end();
-    return std::make_unique<FunDef>(loc.value(), is_internal, signature, std::move(body));
+    return arena.make<FunDef>(loc.value(), is_internal, std::move(signature), std::move(body), arena);
 }
 
 DefArg Parser::parse_def_arg() {
@@ -86,7 +84,7 @@ FunSignature Parser::parse_fun_sig() {
     const auto id = cur_tok;
     expect(TokenType::Id);
     expect(TokenType::LParen);
-    std::vector<DefArg> args;
+    std::pmr::vector<DefArg> args(&arena);
     while (cur_tok.type != TokenType::RParen) {
         args.push_back(parse_def_arg());
         if (cur_tok.type == TokenType::RParen) {
@@ -95,7 +93,7 @@ FunSignature Parser::parse_fun_sig() {
         expect(TokenType::Comma, "Expected ',' or ')'");
     }
     advance();
-    return {id.loc, false, id.lexeme, args, parse_type_anno()};
+    return {id.loc, false, id.ident, std::move(args), parse_type_anno()};
 }
 
 StmtPtr Parser::parse_internal_stmt() {
@@ -113,7 +111,7 @@ StmtPtr Parser::parse_internal_stmt() {
 StmtPtr Parser::parse_expr_stmt() {
     auto expr = parse_expr();
     expect_stmt_end();
-    return std::make_unique<ExprStmt>(expr->loc, std::move(expr));
+    return arena.make<ExprStmt>(expr->loc, std::move(expr));
 }
 
 StmtPtr Parser::parse_external_stmt() {
@@ -124,5 +122,13 @@ StmtPtr Parser::parse_external_stmt() {
     }
     FunSignature sig = parse_fun_sig();
     expect_stmt_end();
-    return std::make_unique<ExternalStmt>(loc, sig);
+    return arena.make<ExternalStmt>(loc, std::move(sig));
+}
+
+StmtPtr Parser::parse_import_stmt() {
+    advance();
+    const auto name = cur_tok;
+    expect(TokenType::Id, "Expected a module name after 'import'");
+    expect_stmt_end();
+    return arena.make<ImportStmt>(name);
 }
@@ -2,58 +2,21 @@
 #include "stmt_nodes.h"
 
 #include "module_collector_error.h"
+#include "token_error.h"
 
 void ModuleCollector::visit(FunDef &def) {
-    mod_scope.add_function(def.loc, def.signature);
+    def.signature.sym = mod_scope.add_function(def.loc, def.signature, def.is_internal);
 }
 
 void ModuleCollector::visit(ExternalStmt &stmt) {
-    mod_scope.add_function(stmt.loc, stmt.signature);
+    stmt.signature.sym = mod_scope.add_function(stmt.loc, stmt.signature);
 }
 
-void ModuleCollector::visit(VarInit &stmt) {
-}
-
-void ModuleCollector::visit(TypeAnno &typeAnno) {
-}
-
-void ModuleCollector::visit(ParenExpr &expr) {
-}
-
-void ModuleCollector::visit(BlockExpr &expr) {
-}
-
-void ModuleCollector::visit(UnaryExpr &expr) {
-}
-
-void ModuleCollector::visit(BinaryExpr &expr) {
-}
-
-void ModuleCollector::visit(IdExpr &expr) {
-}
-
-void ModuleCollector::visit(IfElseExpr &expr) {
-}
-
-void ModuleCollector::visit(WhileExpr &expr) {
-}
-
-void ModuleCollector::visit(IntConst &expr) {
-}
-
-void ModuleCollector::visit(FloatConst &expr) {
-}
-
-void ModuleCollector::visit(CharConst &expr) {
-}
-
-void ModuleCollector::visit(StringConst &expr) {
-}
-
-void ModuleCollector::visit(BoolConst &expr) {
-}
-
-void ModuleCollector::visit(FunCall &expr) {
+void ModuleCollector::visit(ImportStmt &stmt) {
+    if (!stmt.module) {
+        throw TokenError("Module " + std::string(stmt.name.str()) + " hasn't been loaded", stmt.loc);
+    }
+    mod_scope.add_module(stmt.loc, stmt.name, *stmt.module);
 }
 
 void ModuleCollector::visit(ExprStmt &stmt) {
@@ -63,9 +26,3 @@ void ModuleCollector::visit(ExprStmt &stmt) {
 void ModuleCollector::visit(Assignment &stmt) {
     throw ModuleCollectorError(stmt);
 }
-
-void ModuleCollector::visit(DefArg &arg) {
-}
-
-void ModuleCollector::visit(FunSignature &signature) {
-}
\ No newline at end of file
@@ -12,7 +12,7 @@ void NameResolution::visit(TypeAnno &typeAnno) {
 
 void NameResolution::visit(ParenExpr &expr) {
     expr.parent_scope = scope;
-    expr.expr->accept(*this);
+    dispatch(*expr.expr);
 }
 
 void NameResolution::visit(BlockExpr &expr) {
@@ -20,46 +20,47 @@ void NameResolution::visit(BlockExpr &expr) {
     scope = &expr.scope;
     scope->parent_scope = expr.parent_scope;
     for (const auto& stmt: expr.body) {
-        stmt->accept(*this);
+        dispatch(*stmt);
     }
     scope = expr.parent_scope;
 }
 
 void NameResolution::visit(UnaryExpr &expr) {
     expr.parent_scope = scope;
-    expr.operand->accept(*this);
+    dispatch(*expr.operand);
 }
 
 void NameResolution::visit(BinaryExpr &expr) {
     expr.parent_scope = scope;
-    expr.lhs->accept(*this);
-    expr.rhs->accept(*this);
+    dispatch(*expr.lhs);
+    dispatch(*expr.rhs);
 }
 
 void NameResolution::visit(IdExpr &expr) {
     expr.parent_scope = scope;
-    if (!expr.parent_scope->resolve(expr.id).has_value()) {
-        throw UnknownIdError(expr.loc, expr.id);
+    expr.sym = expr.parent_scope->resolve(expr.id);
+    if (!expr.sym) {
+        throw UnknownIdError(expr.loc, expr.id.str());
     }
-    auto sym = expr.parent_scope->get_symbol(expr.id).kind;
+    const auto& sym = expr.sym->kind;
     if (!std::holds_alternative<VarSymbol>(sym) && !std::holds_alternative<ParamSymbol>(sym)) {
-        throw TokenError(expr.id + " is a " + string_of_symbol_type(sym) + " and can't be used in this context", expr.loc);
+        throw TokenError(std::string(expr.id.str()) + " is a " + string_of_symbol_type(sym) + " and can't be used in this context", expr.loc);
     }
 }
 
 void NameResolution::visit(IfElseExpr &expr) {
     expr.parent_scope = scope;
-    expr.condition->accept(*this);
-    expr.if_branch->accept(*this);
+    dispatch(*expr.condition);
+    dispatch(*expr.if_branch);
     if (expr.else_branch.has_value()) {
-        expr.else_branch.value()->accept(*this);
+        dispatch(*expr.else_branch.value());
     }
 }
 
 void NameResolution::visit(WhileExpr &expr) {
     expr.parent_scope = scope;
-    expr.condition->accept(*this);
-    expr.body->accept(*this);
+    dispatch(*expr.condition);
+    dispatch(*expr.body);
 }
 
 void NameResolution::visit(IntConst &expr) {
@@ -79,89 +80,119 @@ void NameResolution::visit(BoolConst &expr) {
 }
 
 void NameResolution::visit(FunCall &expr) {
-    if (expr.callee == "main") {
+    if (expr.callee == main_ident) {
         throw TokenError("The \"main\" function can't be called", expr.loc);
     }
     expr.parent_scope = scope;
     for (const auto& arg: expr.args) {
-        arg->accept(*this);
+        dispatch(*arg);
     }
 
-    if (expr.callee == "printf") {
+    if (expr.qualifier.id) {
+        resolve_qualified(expr);
         return;
     }
-    if (!scope->resolve(expr.callee).has_value()) {
-        throw UnknownIdError(expr.loc, expr.callee);
+    if (expr.callee == printf_ident) {
+        return;
+    }
+    expr.sym = scope->resolve(expr.callee);
+    if (!expr.sym) {
+        throw UnknownIdError(expr.loc, expr.callee.str());
     }
-    if (!expr.parent_scope->is_function(expr.callee)) {
-        throw TokenError(expr.callee + " is a " +
-            string_of_symbol_type(expr.parent_scope->get_symbol(expr.callee).kind)
+    if (!std::holds_alternative<FunSymbol>(expr.sym->kind)) {
+        throw TokenError(std::string(expr.callee.str()) + " is a " + string_of_symbol_type(expr.sym->kind)
             + " and can't be used in this context", expr.loc);
     }
 }
 
 void NameResolution::visit(ExprStmt &stmt) {
     stmt.parent_scope = scope;
-    stmt.expr->accept(*this);
+    dispatch(*stmt.expr);
 }
 
 void NameResolution::visit(VarInit &stmt) {
     stmt.parent_scope = scope;
-    scope->add_var(stmt.loc, stmt);
+    stmt.sym = scope->add_var(stmt.loc, stmt);
     if (stmt.anno.has_value()) {
-        stmt.anno.value().accept(*this);
+        visit(stmt.anno.value());
     }
-    stmt.val->accept(*this);
+    dispatch(*stmt.val);
 }
 
 void NameResolution::visit(Assignment &stmt) {
     stmt.parent_scope = scope;
-    if (!stmt.parent_scope->resolve(stmt.assignee).has_value()) {
-        throw UnknownIdError(stmt.loc, stmt.assignee);
+    stmt.sym = stmt.parent_scope->resolve(stmt.assignee);
+    if (!stmt.sym) {
+        throw UnknownIdError(stmt.loc, stmt.assignee.str());
     }
-    if (!stmt.parent_scope->can_be_reassigned(stmt.assignee)) {
-        throw TokenError(stmt.assignee + " can't be reassigned!", stmt.loc);
+    if (!can_be_reassigned(*stmt.sym)) {
+        throw TokenError(std::string(stmt.assignee.str()) + " can't be reassigned!", stmt.loc);
     }
-    stmt.val->accept(*this);
+    stmt.sym->is_reassigned = true;
+    dispatch(*stmt.val);
 
 }
 
 void NameResolution::visit(DefArg &arg) {
     arg.parent_scope = scope;
-    scope->add_param(arg);
+    arg.sym = scope->add_param(arg);
 
 }
 
 void NameResolution::visit(FunSignature &signature) {
     signature.parent_scope = scope;
     for (auto& arg : signature.args) {
-        arg.accept(*this);
+        visit(arg);
     }
-    signature.anno.accept(*this);
+    visit(signature.anno);
 }
 
 void NameResolution::visit(FunDef &def) {
     def.parent_scope = scope;
     if (scope->kind != Scope::Kind::Module) {
-        scope->add_function(def.loc, def.signature);
+        def.signature.sym = scope->add_function(def.loc, def.signature, def.is_internal);
     }
     scope = &def.scope;
     scope->parent_scope = def.parent_scope;
-    def.signature.accept(*this);
-    def.body->accept(*this);
+    visit(def.signature);
+    dispatch(*def.body);
     scope = def.parent_scope;
 }
 
 void NameResolution::visit(ExternalStmt &stmt) {
-    if (stmt.signature.id == "main") {
+    if (stmt.signature.id == main_ident) {
         throw TokenError("function \"main\" can't be declared as external",stmt.signature.loc);
     }
     stmt.parent_scope = scope;
     if (scope->kind != Scope::Kind::Module) {
-        scope->add_function(stmt.loc, stmt.signature);
+        stmt.signature.sym = scope->add_function(stmt.loc, stmt.signature);
     }
-    stmt.signature.accept(*this);
+    visit(stmt.signature);
 }
 
+void NameResolution::visit(ImportStmt &stmt) {
+    stmt.parent_scope = scope;
+    if (scope->kind != Scope::Kind::Module) {
+        throw TokenError("Modules can only be imported at the module level", stmt.loc);
+    }
+}
 
-
+void NameResolution::resolve_qualified(FunCall &expr) const {
+    const std::string module_name(expr.qualifier.str());
+    const Symbol* sym = scope->resolve(expr.qualifier);
+    if (!sym) {
+        throw UnknownIdError(expr.loc, module_name);
+    }
+    const auto* imported = std::get_if<ModuleSymbol>(&sym->kind);
+    if (!imported) {
+        throw TokenError(module_name + " is a " + string_of_symbol_type(sym->kind) + " and not a module", expr.loc);
+    }
+    expr.sym = imported->module.scope.symbols.find(expr.callee);
+    const auto* fun = expr.sym ? std::get_if<FunSymbol>(&expr.sym->kind) : nullptr;
+    if (!fun) {
+        throw TokenError("Module " + module_name + " has no function " + std::string(expr.callee.str()), expr.loc);
+    }
+    if (fun->is_internal) {
+        throw TokenError(std::string(expr.callee.str()) + " is internal to module " + module_name, expr.loc);
+    }
+}
@@ -1,53 +1,59 @@
 #pragma once
-#include "visitor.h"
+#include "node_visitor.h"
 
 struct Scope;
 
-struct NameResolution final : Visitor {
+struct NameResolution final : NodeVisitor<NameResolution> {
     Scope* scope;
 
     explicit NameResolution(Scope* scope = nullptr)
         : scope(scope) {}
 
-    void visit(TypeAnno &typeAnno) override;
+    void visit(TypeAnno &typeAnno);
 
-    void visit(ParenExpr &expr) override;
+    void visit(ParenExpr &expr);
 
-    void visit(BlockExpr &expr) override;
+    void visit(BlockExpr &expr);
 
-    void visit(UnaryExpr &expr) override;
+    void visit(UnaryExpr &expr);
 
-    void visit(BinaryExpr &expr) override;
+    void visit(BinaryExpr &expr);
 
-    void visit(IdExpr &expr) override;
+    void visit(IdExpr &expr);
 
-    void visit(IfElseExpr &expr) override;
+    void visit(IfElseExpr &expr);
 
-    void visit(WhileExpr &expr) override;
+    void visit(WhileExpr &expr);
 
-    void visit(IntConst &expr) override;
+    void visit(IntConst &expr);
 
-    void visit(FloatConst &expr) override;
+    void visit(FloatConst &expr);
 
-    void visit(CharConst &expr) override;
+    void visit(CharConst &expr);
 
-    void visit(StringConst &expr) override;
+    void visit(StringConst &expr);
 
-    void visit(BoolConst &expr) override;
+    void visit(BoolConst &expr);
 
-    void visit(FunCall &expr) override;
+    void visit(FunCall &expr);
 
-    void visit(ExprStmt &stmt) override;
+    void visit(ExprStmt &stmt);
 
-    void visit(VarInit &stmt) override;
+    void visit(VarInit &stmt);
 
-    void visit(Assignment &stmt) override;
+    void visit(Assignment &stmt);
 
-    void visit(DefArg &arg) override;
+    void visit(DefArg &arg);
 
-    void visit(FunSignature &signature) override;
+    void visit(FunSignature &signature);
 
-    void visit(FunDef &def) override;
+    void visit(FunDef &def);
 
-    void visit(ExternalStmt &stmt) override;
+    void visit(ExternalStmt &stmt);
+
+    void visit(ImportStmt &stmt);
+
+private:
+    // module.callee(...), which can only refer to a function at the top of the module
+    void resolve_qualified(FunCall &expr) const;
 };
\ No newline at end of file
@@ -1,68 +1,51 @@
 #include "scope.h"
 
 #include "double_definition_error.h"
-#include "module.h"
 #include "stmt_nodes.h"
 
-Scope::Scope(Kind kind, Scope* parent_scope)
-    : kind(kind), parent_scope(parent_scope) {}
+// Module scopes hold every top level function, so they start out as a map
+constexpr size_t module_symbols = 64;
 
-std::optional<Symbol> Scope::resolve(const std::string &name) const {
-    auto tmp = this;
-    while (tmp) {
-        if (tmp->symbols.contains(name)) {
-            return tmp->symbols.at(name);
-        }
-        tmp = tmp->parent_scope;
+Scope::Scope(Kind kind, std::pmr::memory_resource& resource, Scope* parent_scope)
+    : kind(kind), parent_scope(parent_scope), symbols(resource), resource(resource) {
+    if (kind == Kind::Module) {
+        symbols.reserve(module_symbols);
     }
-    return {};
 }
 
-Symbol& Scope::get_symbol(const std::string &name) {
-    auto tmp = this;
-    while (tmp) {
-        if (tmp->symbols.contains(name)) {
-            return tmp->symbols.at(name);
+Symbol* Scope::resolve(const Ident name) const {
+    for (auto tmp = this; tmp; tmp = tmp->parent_scope) {
+        if (Symbol* sym = tmp->symbols.find(name)) {
+            return sym;
         }
-        tmp = tmp->parent_scope;
-    }
-    throw std::runtime_error("get_symbol should only be used after name resolution!");
-}
-
-void Scope::add_function(Location& loc, FunSignature &sig) {
-    if (symbols.contains(sig.id)) {
-        throw DoubleDefinitionError(sig.id, loc);
     }
-    symbols.emplace(sig.id, FunSymbol(sig));
+    return nullptr;
 }
 
-void Scope::add_module(Module &module) {
-    symbols.emplace(module.name, ModuleSymbol(module));
+Symbol* Scope::new_symbol(SymbolKind kind) {
+    return std::pmr::polymorphic_allocator<>(&resource).new_object<Symbol>(std::move(kind));
 }
 
-void Scope::add_var(Location& loc, VarInit &var) {
-    if (symbols.contains(var.id)) {
-        throw DoubleDefinitionError(var.id, loc);
+Symbol* Scope::add(const Ident name, const Location& loc, SymbolKind kind) {
+    Symbol* sym = new_symbol(std::move(kind));
+    if (!symbols.insert(name, sym)) {
+        throw DoubleDefinitionError(name.str(), loc);
     }
-    symbols.emplace(var.id, VarSymbol(var.is_const, var));
+    return sym;
 }
 
-void Scope::add_param(DefArg &arg) {
-    if (symbols.contains(arg.id)) {
-        throw DoubleDefinitionError(arg.id, arg.loc);
-    }
-    symbols.emplace(arg.id, ParamSymbol(arg));
+Symbol* Scope::add_function(Location& loc, FunSignature &sig, const bool is_internal) {
+    return add(sig.id, loc, FunSymbol(sig, is_internal));
 }
 
-bool Scope::is_function(const std::string &name){
-    return std::holds_alternative<FunSymbol>(get_symbol(name).kind);
+Symbol* Scope::add_module(const Location& loc, const Ident name, Module &module) {
+    return add(name, loc, ModuleSymbol(module));
 }
 
-bool Scope::can_be_reassigned(const std::string &id) {
-    if (std::holds_alternative<VarSymbol>(get_symbol(id).kind)) {
-        return !std::get<VarSymbol>(get_symbol(id).kind).is_const;
-    }
-    return std::holds_alternative<ParamSymbol>(get_symbol(id).kind);
+Symbol* Scope::add_var(Location& loc, VarInit &var) {
+    return add(var.id, loc, VarSymbol(var.is_const, var));
 }
 
-
+Symbol* Scope::add_param(DefArg &arg) {
+    return add(arg.id, arg.loc, ParamSymbol(arg));
+}
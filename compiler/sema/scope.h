@@ -1,8 +1,9 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include <memory_resource>
 
+#include "interner.h"
 #include "symbol.h"
+#include "symbol_table.h"
 
 
 struct Location;
@@ -11,24 +12,27 @@ struct DefArg;
 struct Scope {
     enum class Kind {Block, Function, Module} kind;
     Scope* parent_scope;
-    std::unordered_map<std::string, Symbol> symbols;
+    // The symbols live in the same memory resource as the table
+    SymbolTable symbols;
 
-    explicit Scope(Kind kind, Scope* parent_scope = nullptr);
+    Scope(Kind kind, std::pmr::memory_resource& resource, Scope* parent_scope = nullptr);
 
-    std::optional<Symbol> resolve(const std::string& name) const;
+    // Searches this scope and its parents, nullptr if name isn't defined
+    Symbol* resolve(Ident name) const;
 
-    // Should only be used after name resolution
-    Symbol& get_symbol(const std::string& name);
+    // The add functions return the new symbol
+    Symbol* add_function(Location& loc,  FunSignature& sig, bool is_internal = false);
 
-    void add_function(Location& loc,  FunSignature& sig);
+    // Makes module available under the name it was imported as
+    Symbol* add_module(const Location& loc, Ident name, Module& module);
 
-    void add_module(Module& module);
+    Symbol* add_var(Location& loc, VarInit& var);
 
-    void add_var(Location& loc, VarInit& var);
+    Symbol* add_param(DefArg& arg);
 
-    void add_param(DefArg& arg);
+private:
+    std::pmr::memory_resource& resource;
 
-    bool is_function(const std::string& name);
-
-    bool can_be_reassigned(const std::string& id);
+    Symbol* new_symbol(SymbolKind kind);
+    Symbol* add(Ident name, const Location& loc, SymbolKind kind);
 };
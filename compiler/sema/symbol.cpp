@@ -16,3 +16,10 @@ std::string string_of_symbol_type(const SymbolKind& sym) {
     }
     return "";
 }
+
+bool can_be_reassigned(const Symbol& sym) {
+    if (const auto* var = std::get_if<VarSymbol>(&sym.kind)) {
+        return !var->is_const;
+    }
+    return std::holds_alternative<ParamSymbol>(sym.kind);
+}
@@ -10,7 +10,7 @@ struct Module;
 struct Type;
 
 namespace llvm {
-class AllocaInst;
+class Value;
 }
 
 struct VarSymbol {
@@ -20,6 +20,8 @@ struct VarSymbol {
 
 struct FunSymbol {
     FunSignature& signature;
+    // Internal functions can't be called from other modules
+    bool is_internal = false;
 };
 
 struct ModuleSymbol {
@@ -35,7 +37,13 @@ using SymbolKind = std::variant<VarSymbol, FunSymbol, ModuleSymbol, ParamSymbol>
 struct Symbol {
     SymbolKind kind;
     Type* type = nullptr;
-    llvm::AllocaInst* val = nullptr;
+    // Set by name resolution when an assignment targets the symbol
+    bool is_reassigned = false;
+    // The stack slot of a reassigned variable or parameter, otherwise its value
+    llvm::Value* val = nullptr;
 };
 
-std::string string_of_symbol_type(const SymbolKind&);
\ No newline at end of file
+std::string string_of_symbol_type(const SymbolKind&);
+
+// Only mutable variables and parameters can be reassigned
+bool can_be_reassigned(const Symbol& sym);
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "symbol_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+Symbol* SymbolTable::find(const Ident id) const {
+    if (!slots) {
+        for (size_t i = 0; i < count; i++) {
+            if (small[i].id == id) {
+                return small[i].symbol;
+            }
+        }
+        return nullptr;
+    }
+    return probe(id).symbol;
+}
+
+bool SymbolTable::insert(const Ident id, Symbol* symbol) {
+    if (!slots) {
+        for (size_t i = 0; i < count; i++) {
+            if (small[i].id == id) {
+                return false;
+            }
+        }
+        if (count < inline_capacity) {
+            small[count++] = {id, symbol};
+            return true;
+        }
+        rehash(4 * inline_capacity);
+    }
+    Entry& entry = probe(id);
+    if (entry.symbol) {
+        return false;
+    }
+    entry = {id, symbol};
+    // Keeps the load factor at or below 1/2
+    if (++count * 2 > slot_count) {
+        rehash(2 * slot_count);
+    }
+    return true;
+}
+
+void SymbolTable::reserve(const size_t count) {
+    const size_t needed = std::bit_ceil(2 * count);
+    if (needed > inline_capacity && needed > slot_count) {
+        rehash(needed);
+    }
+}
+
+SymbolTable::Entry& SymbolTable::probe(const Ident id) const {
+    const size_t mask = slot_count - 1;
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        if (slots[i].id == id || !slots[i].symbol) {
+            return slots[i];
+        }
+    }
+}
+
+void SymbolTable::rehash(const size_t new_slot_count) {
+    Entry* old = slots;
+    const size_t old_count = slot_count;
+    slots = static_cast<Entry*>(resource->allocate(new_slot_count * sizeof(Entry), alignof(Entry)));
+    std::uninitialized_value_construct_n(slots, new_slot_count);
+    slot_count = new_slot_count;
+    shift = 64 - std::countr_zero(new_slot_count);
+
+    auto move_in = [this](const Entry& entry) {
+        if (entry.symbol) {
+            probe(entry.id) = entry;
+        }
+    };
+    if (old) {
+        std::for_each(old, old + old_count, move_in);
+        resource->deallocate(old, old_count * sizeof(Entry), alignof(Entry));
+    } else {
+        std::for_each(small.begin(), small.begin() + count, move_in);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "interner.h"
+
+struct Symbol;
+
+// Maps identifiers to symbols. Most scopes hold only a handful of symbols, those are kept inline
+// and searched linearly. Once a table outgrows the inline entries it moves to an open addressing
+// map allocated from the memory resource.
+class SymbolTable {
+public:
+    explicit SymbolTable(std::pmr::memory_resource& resource) : resource(&resource) {}
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    // nullptr if id isn't in the table
+    Symbol* find(Ident id) const;
+
+    // Returns false and leaves the table unchanged if id is already in it
+    bool insert(Ident id, Symbol* symbol);
+
+    // Switches to the map right away, for tables known to get large
+    void reserve(size_t count);
+
+    size_t size() const { return count; }
+
+    // Memory of the map, zero while the entries are inline
+    size_t bytes() const { return slot_count * sizeof(Entry); }
+
+private:
+    // A free slot has no symbol
+    struct Entry {
+        Ident id;
+        Symbol* symbol = nullptr;
+    };
+    static constexpr size_t inline_capacity = 8;
+
+    std::pmr::memory_resource* resource;
+    size_t count = 0;
+    std::array<Entry, inline_capacity> small{};
+    // The open addressing map, nullptr while the entries are inline
+    Entry* slots = nullptr;
+    size_t slot_count = 0;
+    int shift = 0;
+
+    // Ids are dense, multiplying spreads neighbouring ids over the whole map
+    size_t home(const Ident id) const { return (id.id * 0x9E3779B97F4A7C15ull) >> shift; }
+    Entry& probe(Ident id) const;
+    void rehash(size_t new_slot_count);
+};
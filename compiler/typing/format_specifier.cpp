@@ -6,7 +6,7 @@
 #include "type_error.h"
 
 Location shift_col(const Location& loc,size_t i) {
-    return {*loc.src, loc.start.line, loc.start.column + static_cast<int>(i), loc.end.column};
+    return {loc.src(), loc.offset() + i, loc.length - i};
 }
 
 bool is_format_char(char c) {
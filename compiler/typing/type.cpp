@@ -33,16 +33,9 @@ std::string BasicTy::to_string() const {
     }
 }
 
-std::unique_ptr<Type> BasicTy::clone() const {
-    return std::make_unique<BasicTy>(kind);
-}
-
 FunctionTy::FunctionTy(std::vector<Type *> v, Type * t)
     : arg_types(std::move(v)), return_type(t){}
 
 std::string FunctionTy::to_string() const {
     return "(" + vec_to_string(arg_types, ", ") + ") -> " + return_type->to_string();
-}
-std::unique_ptr<Type> FunctionTy::clone() const {
-    return std::make_unique<FunctionTy>(arg_types, return_type);
 }
\ No newline at end of file
@@ -7,8 +7,6 @@ struct Type {
     virtual ~Type() = default;
 
     virtual std::string to_string() const = 0;
-
-    virtual std::unique_ptr<Type> clone() const = 0;
 };
 
 
@@ -18,8 +16,6 @@ struct BasicTy final : Type {
     explicit BasicTy(Kind);
 
     std::string to_string() const override;
-
-    std::unique_ptr<Type> clone() const override;
 };
 
 
@@ -30,6 +26,4 @@ struct FunctionTy final : Type {
     FunctionTy(std::vector<Type*>, Type*);
 
     std::string to_string() const override;
-
-    std::unique_ptr<Type> clone() const override;
 };
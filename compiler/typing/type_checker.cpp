@@ -9,17 +9,8 @@
 #include "token_error.h"
 #include "type_error.h"
 
-TypeChecker::TypeChecker(std::unordered_map<std::string, std::unique_ptr<Type>>& type_env)
-    : type_env(type_env){}
-
-
-Type* TypeChecker::add_type(const Type& type) const {
-    const std::string type_string = type.to_string();
-    if (!type_env.contains(type_string)) {
-        type_env[type_string] = type.clone();
-    }
-    return type_env.at(type_string).get();
-}
+TypeChecker::TypeChecker(TypeInterner& types)
+    : types(types){}
 
 void TypeChecker::visit(TypeAnno &typeAnno) {
     using enum TypeAnno::Kind;
@@ -34,7 +25,7 @@ void TypeChecker::visit(TypeAnno &typeAnno) {
 }
 
 void TypeChecker::visit(ParenExpr &expr) {
-    expr.expr->accept(*this);
+    dispatch(*expr.expr);
     expr.type = expr.expr->type;
 }
 
@@ -45,7 +36,7 @@ void TypeChecker::visit(BlockExpr &expr) {
     }
     const size_t len = expr.body.size();
     for (size_t i = 0; i < len; i++) {
-        expr.body[i]->accept(*this);
+        dispatch(*expr.body[i]);
         if (i != len-1 && expr.body[i]->type != unit_ty()) {
             throw TypeError(expr.body[i]->loc, "Non unit expressions can only come at the end of a block."
                                                "Consider using \"let\" or \"var\"");
@@ -56,7 +47,7 @@ void TypeChecker::visit(BlockExpr &expr) {
 }
 
 void TypeChecker::visit(UnaryExpr &expr) {
-    expr.operand->accept(*this);
+    dispatch(*expr.operand);
     using enum UnaryOp;
     switch (expr.op) {
         case Not: if (expr.operand->type != bool_ty()) {
@@ -71,8 +62,8 @@ void TypeChecker::visit(UnaryExpr &expr) {
 }
 
 void TypeChecker::visit(BinaryExpr &expr) {
-    expr.lhs->accept(*this);
-    expr.rhs->accept(*this);
+    dispatch(*expr.lhs);
+    dispatch(*expr.rhs);
     auto* l_ty = expr.lhs->type;
     auto* r_ty = expr.rhs->type;
 
@@ -118,21 +109,21 @@ void TypeChecker::visit(BinaryExpr &expr) {
 }
 
 void TypeChecker::visit(IdExpr &expr) {
-    expr.type = expr.parent_scope->get_symbol(expr.id).type;
+    expr.type = expr.sym->type;
 
 }
 
 void TypeChecker::visit(IfElseExpr &expr) {
-    expr.condition->accept(*this);
+    dispatch(*expr.condition);
     if (expr.condition->type != bool_ty()) {
         throw TypeError(expr.condition->loc, "Expected an expression of type bool!");
     }
-    expr.if_branch->accept(*this);
+    dispatch(*expr.if_branch);
     if (expr.if_branch->type != unit_ty() && !expr.else_branch.has_value()) {
         throw TypeError(expr.loc, "if branch isn't of type unit but there is no else branch!");
     }
     if (expr.else_branch.has_value()) {
-        expr.else_branch.value()->accept(*this);
+        dispatch(*expr.else_branch.value());
 
         if (expr.if_branch->type != expr.else_branch.value()->type) {
             throw TypeError(expr.loc, "Both branches need to have the same type!");
@@ -142,12 +133,12 @@ void TypeChecker::visit(IfElseExpr &expr) {
 }
 
 void TypeChecker::visit(WhileExpr &expr) {
-    expr.condition->accept(*this);
+    dispatch(*expr.condition);
     if (expr.condition->type != bool_ty()) {
         throw TypeError(expr.condition->loc, "Expected an expression of type bool!");
     }
 
-    expr.body->accept(*this);
+    dispatch(*expr.body);
     expr.type = expr.body->type;
 }
 
@@ -175,24 +166,24 @@ void TypeChecker::visit(BoolConst &expr) {
 
 void TypeChecker::visit(FunCall &expr) {
     for (const auto& arg: expr.args) {
-        arg->accept(*this);
+        dispatch(*arg);
     }
-    if (expr.callee == "printf") {
+    if (!expr.qualifier.id && expr.callee == printf_ident) {
         handle_printf(expr);
         return;
     }
 
     // Necessary for all functions not defined at the module level
-    if (!expr.parent_scope->get_symbol(expr.callee).type) {
-        const auto& sym = std::get<FunSymbol>(expr.parent_scope->get_symbol(expr.callee).kind);
-        sym.signature.accept(*this);
-        expr.parent_scope->get_symbol(expr.callee).type = sym.signature.type;
+    if (!expr.sym->type) {
+        const auto& sym = std::get<FunSymbol>(expr.sym->kind);
+        visit(sym.signature);
+        expr.sym->type = sym.signature.type;
     }
 
-    const auto f_type = dynamic_cast<FunctionTy*>(expr.parent_scope->get_symbol(expr.callee).type);
+    const auto f_type = dynamic_cast<FunctionTy*>(expr.sym->type);
     if (expr.args.size() != f_type->arg_types.size()) {
         throw TypeError(expr.loc,
-            expr.callee + " expects " + std::to_string(expr.args.size()) + " arguments, found " +
+            std::string(expr.callee.str()) + " expects " + std::to_string(expr.args.size()) + " arguments, found " +
            std::to_string( f_type->arg_types.size()));
     }
     for (size_t i = 0; i < expr.args.size(); i++) {
@@ -229,64 +220,67 @@ void TypeChecker::handle_printf(FunCall &expr) const {
 }
 
 void TypeChecker::visit(ExprStmt &stmt) {
-    stmt.expr->accept(*this);
+    dispatch(*stmt.expr);
     stmt.type = stmt.expr->type;
 }
 
 void TypeChecker::visit(VarInit &stmt) {
-    stmt.val->accept(*this);
+    dispatch(*stmt.val);
     if (stmt.anno.has_value()) {
-        stmt.anno.value().accept(*this);
+        visit(stmt.anno.value());
         if (stmt.anno.value().type != stmt.val->type) {
             throw AnnoMismatchError(stmt);
         }
     }
-    stmt.parent_scope->get_symbol(stmt.id).type = stmt.val->type;
+    stmt.sym->type = stmt.val->type;
     stmt.type = unit_ty();
 }
 
 void TypeChecker::visit(Assignment &stmt) {
-    stmt.val->accept(*this);
-    if (stmt.val->type != stmt.parent_scope->get_symbol(stmt.assignee).type) {
-        throw TypeError(stmt.loc, stmt.assignee + " has type " +
-            stmt.parent_scope->get_symbol(stmt.assignee).type->to_string());
+    dispatch(*stmt.val);
+    if (stmt.val->type != stmt.sym->type) {
+        throw TypeError(stmt.loc, std::string(stmt.assignee.str()) + " has type " + stmt.sym->type->to_string());
     }
     stmt.type = unit_ty();
 }
 
 void TypeChecker::visit(DefArg &arg) {
-    arg.anno.accept(*this);
-    arg.parent_scope->get_symbol(arg.id).type = arg.anno.type;
+    visit(arg.anno);
+    arg.sym->type = arg.anno.type;
 }
 
 void TypeChecker::visit(FunSignature &signature) {
     std::vector<Type*> args;
     for (auto& arg: signature.args) {
-        arg.accept(*this);
+        visit(arg);
         args.push_back(arg.anno.type);
     }
-    signature.anno.accept(*this);
-    signature.type = add_type(FunctionTy(args, signature.anno.type));
+    visit(signature.anno);
+    signature.type = types.function(args, signature.anno.type);
 
 }
 
 void TypeChecker::visit(FunDef &def) {
     def.type = unit_ty();
-    def.signature.accept(*this);
-    def.body->accept(*this);
+    visit(def.signature);
+    dispatch(*def.body);
 
-    if (def.signature.id == "main" && def.signature.anno.type != int_ty()) {
+    if (def.signature.id == main_ident && def.signature.anno.type != int_ty()) {
         throw TokenError("The main function has to have a return type of int", def.signature.anno.loc);
     }
 
     if (def.body->type != def.signature.anno.type) {
         throw TokenError("Type of function body doesn't match type annotation", def.signature.loc);
     }
-    def.parent_scope->get_symbol(def.signature.id).type = def.signature.type;
+    def.signature.sym->type = def.signature.type;
 }
 
 void TypeChecker::visit(ExternalStmt &stmt) {
     stmt.type = unit_ty();
-    stmt.signature.accept(*this);
-    stmt.parent_scope->get_symbol(stmt.signature.id).type = stmt.signature.type;
-}
\ No newline at end of file
+    visit(stmt.signature);
+    stmt.signature.sym->type = stmt.signature.type;
+}
+
+void TypeChecker::visit(ImportStmt &stmt) {
+    stmt.type = unit_ty();
+}
@@ -0,0 +1,48 @@
+#include "type_interner.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+
+TypeInterner::TypeInterner()
+    : basics{BasicTy(BasicTy::Kind::Int), BasicTy(BasicTy::Kind::Float), BasicTy(BasicTy::Kind::Bool),
+             BasicTy(BasicTy::Kind::Char), BasicTy(BasicTy::Kind::String), BasicTy(BasicTy::Kind::Unit)} {}
+
+Type* TypeInterner::function(const std::span<Type* const> arg_types, Type* return_type) {
+    const FunctionKey key{arg_types, return_type};
+    {
+        std::shared_lock lock(mutex);
+        if (const auto it = functions.find(key); it != functions.end()) {
+            return it->second.get();
+        }
+    }
+    std::unique_lock lock(mutex);
+    if (const auto it = functions.find(key); it != functions.end()) {
+        return it->second.get();
+    }
+    auto ty = std::make_unique<FunctionTy>(std::vector(arg_types.begin(), arg_types.end()), return_type);
+    FunctionTy* result = ty.get();
+    functions.emplace(FunctionKey{result->arg_types, return_type}, std::move(ty));
+    return result;
+}
+
+size_t TypeInterner::function_count() const {
+    std::shared_lock lock(mutex);
+    return functions.size();
+}
+
+bool TypeInterner::FunctionKey::operator==(const FunctionKey& other) const {
+    return return_type == other.return_type && std::ranges::equal(arg_types, other.arg_types);
+}
+
+size_t TypeInterner::FunctionKeyHash::operator()(const FunctionKey& key) const {
+    auto mix = [](const size_t hash, const Type* ty) {
+        return std::rotl((hash ^ reinterpret_cast<uintptr_t>(ty)) * 0x9E3779B97F4A7C15ull, 31);
+    };
+    size_t hash = mix(key.arg_types.size(), key.return_type);
+    for (const Type* ty : key.arg_types) {
+        hash = mix(hash, ty);
+    }
+    return hash;
+}
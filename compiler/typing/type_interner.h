@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "type.h"
+
+// Hands out a single Type per structure, so two types are equal exactly when their pointers are.
+// The basic types are created up front and indexed by their kind, function types are hash-consed
+// on the pointers of their components. Safe to use from several threads.
+class TypeInterner {
+public:
+    TypeInterner();
+    TypeInterner(const TypeInterner&) = delete;
+    TypeInterner& operator=(const TypeInterner&) = delete;
+
+    Type* basic(BasicTy::Kind kind) { return &basics[static_cast<size_t>(kind)]; }
+
+    // arg_types and return_type have to come from this interner
+    Type* function(std::span<Type* const> arg_types, Type* return_type);
+
+    // Number of distinct function types
+    size_t function_count() const;
+
+private:
+    // Refers to the components of an interned FunctionTy, or to the arguments of a lookup
+    struct FunctionKey {
+        std::span<Type* const> arg_types;
+        Type* return_type;
+
+        bool operator==(const FunctionKey& other) const;
+    };
+
+    struct FunctionKeyHash {
+        size_t operator()(const FunctionKey& key) const;
+    };
+
+    std::array<BasicTy, 6> basics;
+    mutable std::shared_mutex mutex;
+    // Every key points into the FunctionTy it maps to, which never moves
+    std::unordered_map<FunctionKey, std::unique_ptr<FunctionTy>, FunctionKeyHash> functions;
+};
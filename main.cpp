@@ -1,98 +1,328 @@
-#include <unordered_map>
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <optional>
 #include <llvm/IR/LLVMContext.h>
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/Support/TargetSelect.h"
 
+#include "build.h"
+#include "compiler_options.h"
+#include "emit.h"
+#include "incremental.h"
+#include "mem_stats.h"
 #include "module.h"
+#include "object_cache.h"
 #include "print_visitor.h"
-#include "source_file.h"
-#include "type.h"
-#include "type_checker.h"
+#include "profiler.h"
+#include "target.h"
+#include "type_interner.h"
 
 
 enum class CompilerFlags {
-    PrintAst, EmitIR, None
+    PrintAst, EmitIR, Aot, None
 };
 
 int main(int argc, char** argv) {
-    SourceFile src(argv[1]);
-    std::unordered_map<std::string, std::unique_ptr<Type>> type_env;
-    type_env["int"] = std::make_unique<BasicTy>(BasicTy::Kind::Int);
-    type_env["float"] = std::make_unique<BasicTy>(BasicTy::Kind::Float);
-    type_env["char"] = std::make_unique<BasicTy>(BasicTy::Kind::Char);
-    type_env["string"] = std::make_unique<BasicTy>(BasicTy::Kind::String);
-    type_env["bool"] = std::make_unique<BasicTy>(BasicTy::Kind::Bool);
-    type_env["unit"] = std::make_unique<BasicTy>(BasicTy::Kind::Unit);
-    auto ctx = std::make_unique<llvm::LLVMContext>();
-    TypeChecker ty(type_env);
-
     auto flag = CompilerFlags::None;
+    CompilerOptions options;
+    options.cache_dir = default_cache_dir();
+    std::filesystem::path input;
 
-    for (int i = 1; i < argc; i++) {
+    int first_arg = 1;
+    // `arco build` compiles ahead of time instead of running main
+    if (argc > 1 && std::string_view(argv[1]) == "build") {
+        flag = CompilerFlags::Aot;
+        first_arg = 2;
+    }
+    for (int i = first_arg; i < argc; i++) {
         const std::string arg = argv[i];
-        if (arg == "--ast") {
+        if (arg == "-o" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg.starts_with("--emit=")) {
+            const auto kind = emit_kind_of(arg.substr(7));
+            if (!kind) {
+                std::cout << "Unknown --emit kind " << arg.substr(7) << ", expected exe, obj, asm or bc\n";
+                return 1;
+            }
+            options.emit = *kind;
+        } else if (arg == "--ast") {
             std::cout << "AST\n";
             flag = CompilerFlags::PrintAst;
-            break;
-        }
-        if (arg == "--llvmIR") {
+        } else if (arg == "--llvmIR") {
             flag = CompilerFlags::EmitIR;
-            break;
+        } else if (arg == "--no-cache") {
+            options.cache_dir.clear();
+        } else if (arg.starts_with("--cache-dir=")) {
+            options.cache_dir = arg.substr(12);
+        } else if (arg == "--cache-stats") {
+            options.cache_stats = true;
+        } else if (arg == "--time-phases") {
+            options.time_phases = true;
+        } else if (arg.starts_with("--trace=")) {
+            options.trace_file = arg.substr(8);
+        } else if (arg == "--mem-stats") {
+            options.mem_stats = true;
+        } else if (arg.starts_with("--mem-stats=")) {
+            options.mem_stats = true;
+            options.mem_stats_file = arg.substr(12);
+        } else if (arg == "--profile-generate") {
+            options.profile_generate = true;
+        } else if (arg.starts_with("--profile-generate=")) {
+            options.profile_generate = true;
+            options.profile_file = arg.substr(19);
+        } else if (arg.starts_with("--profile-use=")) {
+            options.profile_use = arg.substr(14);
+        } else if (arg == "--incremental") {
+            options.incremental = true;
+        } else if (arg == "--lazy") {
+            options.lazy = true;
+        } else if (arg.starts_with("--jobs=")) {
+            const std::string_view value = std::string_view(arg).substr(7);
+            unsigned jobs = 0;
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), jobs);
+            if (ec != std::errc() || end != value.data() + value.size() || jobs == 0 || jobs > max_jobs) {
+                std::cout << "Invalid --jobs value " << value << ", expected a number from 1 to " << max_jobs << "\n";
+                return 1;
+            }
+            options.jobs = jobs;
+        } else if (arg.starts_with("--target-cpu=")) {
+            options.target_cpu = arg.substr(13);
+        } else if (arg.starts_with("--target-features=")) {
+            options.target_features = arg.substr(18);
+        } else if (const auto level = opt_level_of(arg)) {
+            options.opt_level = *level;
+        } else if (!arg.starts_with("-") && input.empty()) {
+            input = arg;
         }
     }
 
+    // Only the JIT can compile lazily or incrementally, and incremental compilation is eager
+    if (flag == CompilerFlags::Aot) {
+        options.lazy = false;
+        options.incremental = false;
+    }
+    // Without a cache there is nothing to reuse
+    if (options.cache_dir.empty()) {
+        options.incremental = false;
+    }
+    if (options.incremental) {
+        options.lazy = false;
+    }
+    // The profile runtime is linked into executables, the JIT can't provide it
+    if (options.profile_generate && flag != CompilerFlags::Aot) {
+        std::cout << "--profile-generate needs `arco build`\n";
+        return 1;
+    }
+    if (options.profile_generate && !options.profile_use.empty()) {
+        std::cout << "--profile-generate and --profile-use can't be combined\n";
+        return 1;
+    }
+    if (!options.profile_use.empty() && !std::filesystem::is_regular_file(options.profile_use)) {
+        std::cout << "Can't read the profile " << options.profile_use.string() << "\n";
+        return 1;
+    }
+    // Profiles name the functions of whole modules, not of the pieces the lazy and incremental JIT compile
+    if (!options.profile_use.empty()) {
+        options.lazy = false;
+        options.incremental = false;
+    }
+
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
 
-    auto JIT = cantFail(llvm::orc::LLJITBuilder().create());
-
-    auto &JD = JIT->getMainJITDylib();
-    JD.addGenerator(
-        cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
-            JIT->getDataLayout().getGlobalPrefix())));
-
+    // Declared before the build and the JIT, so their threads have finished when it writes the trace
+    std::optional<Profiler> profiler;
+    if (options.time_phases || !options.trace_file.empty()) {
+        profiler.emplace(options.time_phases, options.trace_file);
+    }
 
+    std::optional<MemStats> mem_stats;
+    if (options.mem_stats) {
+        mem_stats.emplace();
+        mem_stats->sample("start");
+    }
+    auto write_mem_stats = [&] {
+        if (!mem_stats) {
+            return;
+        }
+        if (options.mem_stats_file.empty()) {
+            mem_stats->write_json(llvm::errs());
+            return;
+        }
+        std::error_code ec;
+        llvm::raw_fd_ostream out(options.mem_stats_file.string(), ec, llvm::sys::fs::OF_Text);
+        if (ec) {
+            llvm::errs() << "Can't write " << options.mem_stats_file.string() << ": " << ec.message() << "\n";
+            return;
+        }
+        mem_stats->write_json(out);
+    };
 
-    Module m("module", *ctx, ty);
+    TypeInterner types;
+    Build build(types, options);
 
     try {
-        m.parse(src);
+        build.load(input);
     } catch (const std::exception& e) {
         std::cout << e.what();
         return 1;
     }
+    if (mem_stats) {
+        mem_stats->sample("parse");
+    }
 
     if (flag == CompilerFlags::PrintAst) {
         PrintVisitor visitor;
-        for (const auto& node : m.ast) {
+        for (const auto& node : build.root().ast) {
             node->accept(visitor);
             return 0;
         }
     }
     try {
-        m.run_sema();
-        m.run_type_checker();
-        m.run_codegen();
+        build.compile([&](const Phase phase) {
+            if (mem_stats) {
+                mem_stats->sample(std::string(str_of_phase(phase)));
+            }
+        });
     } catch (const std::exception& e) {
         std::cout << e.what();
         return 1;
     }
+    if (mem_stats) {
+        for (const Module* m : build.modules()) {
+            mem_stats->add(*m);
+        }
+        mem_stats->add(types);
+    }
 
 
     if (flag == CompilerFlags::EmitIR) {
-        m.llvm_module->print(llvm::outs(), nullptr);
+        for (const Module* m : build.modules()) {
+            m->llvm_module->print(llvm::outs(), nullptr);
+        }
+        return 0;
+    }
+
+    if (flag == CompilerFlags::Aot) {
+        if (options.output.empty()) {
+            options.output = input.stem();
+            options.output += extension_of(options.emit);
+        }
+        try {
+            emit(build.modules(), build.root(), options);
+        } catch (const std::exception& e) {
+            std::cout << e.what();
+            return 1;
+        }
+        if (mem_stats) {
+            mem_stats->sample("emit");
+        }
+        write_mem_stats();
         return 0;
     }
 
-    cantFail(JIT->addIRModule(llvm::orc::ThreadSafeModule(std::move(m.llvm_module), std::move(ctx))));
+    std::unique_ptr<DiskObjectCache> cache;
+    llvm::orc::LLJITBuilderState::CompileFunctionCreator compile_with_cache;
+    if (!options.cache_dir.empty()) {
+        cache = std::make_unique<DiskObjectCache>(options.cache_dir, target_machine_builder(options), options.opt_level);
+        compile_with_cache = [&cache](llvm::orc::JITTargetMachineBuilder builder)
+            -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+            auto target_machine = builder.createTargetMachine();
+            if (!target_machine) {
+                return target_machine.takeError();
+            }
+            return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(*target_machine), cache.get());
+        };
+    }
+
+    // The lazy JIT compiles every function through a stub the first time it is called
+    std::unique_ptr<llvm::orc::LLJIT> JIT;
+    if (options.lazy) {
+        JIT = cantFail(llvm::orc::LLLazyJITBuilder()
+            .setJITTargetMachineBuilder(target_machine_builder(options))
+            .setCompileFunctionCreator(compile_with_cache)
+            .create());
+        std::shared_ptr target_machine = create_target_machine(options);
+        JIT->getIRTransformLayer().setTransform(
+            [target_machine, options](llvm::orc::ThreadSafeModule tsm, auto&) {
+                tsm.withModuleDo([&](llvm::Module& m) {
+                    PhaseScope scope(Phase::Optimize, m.getName());
+                    optimize_module(m, *target_machine, options);
+                });
+                return llvm::Expected<llvm::orc::ThreadSafeModule>(std::move(tsm));
+            });
+    } else {
+        JIT = cantFail(llvm::orc::LLJITBuilder()
+            .setJITTargetMachineBuilder(target_machine_builder(options))
+            .setCompileFunctionCreator(compile_with_cache)
+            .create());
+    }
+
+    // Every object passes this layer, whether it was compiled, loaded from a cache or added by the
+    // incremental compiler
+    if (mem_stats) {
+        JIT->getObjTransformLayer().setTransform([&mem_stats](std::unique_ptr<llvm::MemoryBuffer> object) {
+            mem_stats->add_object(object->getBufferSize());
+            return llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>(std::move(object));
+        });
+    }
+
+    auto &JD = JIT->getMainJITDylib();
+    JD.addGenerator(
+        cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            JIT->getDataLayout().getGlobalPrefix())));
+
+    std::unique_ptr<IncrementalCompiler> incremental;
+    if (options.incremental) {
+        incremental = std::make_unique<IncrementalCompiler>(options.cache_dir / "functions", options);
+    }
+    for (Module* m : build.modules()) {
+        PhaseScope scope(Phase::Jit, m->name);
+        if (incremental) {
+            try {
+                for (auto& object : incremental->compile(*m)) {
+                    cantFail(JIT->addObjectFile(std::move(object)));
+                }
+            } catch (const std::exception& e) {
+                std::cout << e.what();
+                return 1;
+            }
+            continue;
+        }
+        llvm::orc::ThreadSafeModule tsm(std::move(m->llvm_module), std::move(m->ctx));
+        if (options.lazy) {
+            cantFail(static_cast<llvm::orc::LLLazyJIT&>(*JIT).addLazyIRModule(std::move(tsm)));
+        } else {
+            cantFail(JIT->addIRModule(std::move(tsm)));
+        }
+    }
 
     // Look up your "main" or entry function
-    const auto MainAddr = cantFail(JIT->lookup("main"));
+    const auto MainAddr = [&] {
+        // Compiles every module that isn't compiled lazily
+        PhaseScope scope(Phase::Jit, "main");
+        return cantFail(JIT->lookup("main"));
+    }();
+    if (mem_stats) {
+        mem_stats->sample("jit");
+    }
+
     using MainFn = int();
     auto *Entry = MainAddr.toPtr<MainFn>();
 
-    return Entry();
-    return 0;
+    const int result = Entry();
+    // After main, so the functions the lazy JIT compiled while running it are counted
+    write_mem_stats();
+    if (cache && options.cache_stats && !incremental) {
+        std::cerr << "object cache: " << cache->hits() << " hits, " << cache->misses() << " misses\n";
+    }
+    if (incremental && options.cache_stats) {
+        std::cerr << "functions: " << incremental->reused() << " reused, " << incremental->compiled() << " compiled\n";
+    }
+    return result;
 
 }
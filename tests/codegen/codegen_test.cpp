@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include "compiler_options.h"
+#include "module.h"
+#include "source_file.h"
+#include "type_interner.h"
+
+
+class CodegenTest : public ::testing::Test {
+protected:
+    TypeInterner types;
+    CompilerOptions options;
+    std::unique_ptr<SourceFile> file;
+    std::unique_ptr<Module> module;
+
+    static void SetUpTestSuite() {
+        llvm::InitializeNativeTarget();
+    }
+
+    // Lowers the source without optimizing it
+    void Compile(const std::vector<std::string>& in) {
+        file = std::make_unique<SourceFile>(in);
+        module = std::make_unique<Module>("testing", types, options);
+        module->parse(*file);
+        module->run_sema();
+        module->run_type_checker();
+        module->run_codegen();
+    }
+
+    template<typename Inst>
+    size_t Count(const std::string_view function) const {
+        size_t n = 0;
+        for (const auto& inst : llvm::instructions(*module->llvm_module->getFunction(function))) {
+            n += llvm::isa<Inst>(inst);
+        }
+        return n;
+    }
+};
+
+
+TEST_F(CodegenTest, BindsLetsAndParametersToValues) {
+    Compile({
+        "fun f(a of int) of int = {",
+        "    let b = a * 2",
+        "    b + a",
+        "}",
+    });
+    EXPECT_EQ(Count<llvm::AllocaInst>("f"), 0);
+    EXPECT_EQ(Count<llvm::LoadInst>("f"), 0);
+    llvm::Function& f = *module->llvm_module->getFunction("f");
+    const auto* ret = llvm::cast<llvm::ReturnInst>(f.back().getTerminator());
+    const auto* sum = llvm::cast<llvm::BinaryOperator>(ret->getReturnValue());
+    // b is the product itself, not a load of it
+    const auto* b = llvm::dyn_cast<llvm::BinaryOperator>(sum->getOperand(0));
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(b->getOpcode(), llvm::Instruction::Mul);
+    EXPECT_EQ(b->getOperand(0), f.getArg(0));
+    EXPECT_EQ(sum->getOperand(1), f.getArg(0));
+}
+
+TEST_F(CodegenTest, SpillsOnlyReassignedSymbols) {
+    Compile({
+        "fun f(a of int) of int = {",
+        "    var c = a",
+        "    let d = a + 1",
+        "    c = c + d",
+        "    c",
+        "}",
+    });
+    ASSERT_EQ(Count<llvm::AllocaInst>("f"), 1);
+    const auto& entry = module->llvm_module->getFunction("f")->getEntryBlock();
+    EXPECT_EQ(llvm::cast<llvm::AllocaInst>(entry.front()).getName(), "c");
+    EXPECT_EQ(Count<llvm::LoadInst>("f"), 2);
+}
+
+TEST_F(CodegenTest, SpillsReassignedParameters) {
+    Compile({
+        "fun f(a of int) of int = {",
+        "    a = a + 1",
+        "    a",
+        "}",
+    });
+    ASSERT_EQ(Count<llvm::AllocaInst>("f"), 1);
+    llvm::Function& f = *module->llvm_module->getFunction("f");
+    const auto& slot = llvm::cast<llvm::AllocaInst>(f.getEntryBlock().front());
+    const auto* store = llvm::cast<llvm::StoreInst>(slot.getNextNode());
+    EXPECT_EQ(store->getValueOperand(), f.getArg(0));
+    EXPECT_EQ(store->getPointerOperand(), &slot);
+    EXPECT_EQ(Count<llvm::LoadInst>("f"), 2);
+}
@@ -0,0 +1,342 @@
+#include "build.h"
+
+#include <algorithm>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include "compiler_options.h"
+#include "incremental.h"
+#include "module.h"
+#include "object_cache.h"
+#include "source_file.h"
+#include "target.h"
+#include "type_interner.h"
+
+
+// Writes the modules of a program into a fresh directory
+class BuildTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+    TypeInterner types;
+    CompilerOptions options;
+
+    static void SetUpTestSuite() {
+        llvm::InitializeNativeTarget();
+    }
+
+    void SetUp() override {
+        const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+        dir = std::filesystem::temp_directory_path() / ("arco_" + std::string(test->name()));
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        options.opt_level = OptLevel::O0;
+        options.jobs = 4;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    void Write(const std::string& name, const std::vector<std::string>& lines) const {
+        std::ofstream out(dir / (name + ".arc"));
+        for (const auto& line : lines) {
+            out << line << "\n";
+        }
+    }
+
+    // The message of the error that loading and compiling main.arc throws, empty if there is none
+    std::string Error() {
+        Build build(types, options);
+        try {
+            build.load(dir / "main.arc");
+            build.compile();
+        } catch (const std::exception& e) {
+            return e.what();
+        }
+        return "";
+    }
+};
+
+static bool contains(const std::string& s, const std::string_view part) {
+    return s.find(part) != std::string::npos;
+}
+
+
+TEST_F(BuildTest, CompilesImportsBeforeTheirImporters) {
+    Write("main", {"import a", "import c", "fun main() of int = a.f() + c.h()"});
+    Write("a", {"import b", "fun f() of int = b.g()"});
+    Write("b", {"fun g() of int = 1"});
+    Write("c", {"import b", "fun h() of int = b.g()"});
+    Build build(types, options);
+    build.load(dir / "main.arc");
+    build.compile();
+
+    std::vector<std::string> names;
+    for (const Module* module : build.modules()) {
+        names.push_back(module->name);
+    }
+    ASSERT_EQ(names.size(), 4);
+    auto position = [&](const std::string& name) {
+        return std::ranges::find(names, name) - names.begin();
+    };
+    EXPECT_LT(position("b"), position("a"));
+    EXPECT_LT(position("b"), position("c"));
+    EXPECT_EQ(names.back(), "main");
+    EXPECT_EQ(&build.root(), build.modules().back());
+}
+
+TEST_F(BuildTest, RejectsImportCycles) {
+    Write("main", {"import a", "fun main() of int = a.f()"});
+    Write("a", {"import b", "fun f() of int = b.g()"});
+    Write("b", {"import a", "fun g() of int = a.f()"});
+    EXPECT_TRUE(contains(Error(), "Import cycle")) << Error();
+}
+
+TEST_F(BuildTest, ReportsMissingModules) {
+    Write("main", {"import nope", "fun main() of int = 0"});
+    const std::string error = Error();
+    EXPECT_TRUE(contains(error, "Can't find module nope")) << error;
+    EXPECT_TRUE(contains(error, "main.arc:1:")) << error;
+}
+
+TEST_F(BuildTest, RejectsDuplicateExportedNames) {
+    Write("main", {"import a", "fun f() of int = 0", "fun main() of int = a.f()"});
+    Write("a", {"fun f() of int = 1"});
+    EXPECT_TRUE(contains(Error(), "f is already defined in module")) << Error();
+
+    // Internal functions don't clash
+    Write("a", {"internal fun f() of int = 1", "fun g() of int = f()"});
+    Write("main", {"import a", "fun f() of int = 0", "fun main() of int = a.g()"});
+    EXPECT_EQ(Error(), "");
+}
+
+TEST_F(BuildTest, RejectsCallsOfInternalFunctions) {
+    Write("main", {"import a", "fun main() of int = a.f()"});
+    Write("a", {"internal fun f() of int = 1"});
+    EXPECT_TRUE(contains(Error(), "f is internal to module a")) << Error();
+}
+
+TEST_F(BuildTest, RethrowsErrorsOfImportedModules) {
+    Write("main", {"import a", "import b", "fun main() of int = a.f() + b.g()"});
+    Write("a", {"fun f() of int = 1"});
+    Write("b", {"fun g() of int = 1.5"});
+    const std::string error = Error();
+    EXPECT_TRUE(contains(error, "b.arc:1:")) << error;
+
+    Write("b", {"fun g() of int = (1 +"});
+    EXPECT_TRUE(contains(Error(), "Syntax Error")) << Error();
+}
+
+class ObjectCacheTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "arco_object_cache_test";
+    CompilerOptions options;
+
+    static void SetUpTestSuite() {
+        llvm::InitializeNativeTarget();
+    }
+
+    void SetUp() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    DiskObjectCache Cache() const {
+        return {dir, target_machine_builder(options), options.opt_level};
+    }
+
+    static llvm::MemoryBufferRef Object(const std::string& contents) {
+        return {contents, "object"};
+    }
+};
+
+
+TEST_F(ObjectCacheTest, LoadsStoredObjects) {
+    const std::string object = "not really an object";
+    {
+        auto cache = Cache();
+        EXPECT_EQ(cache.load("ir"), nullptr);
+        cache.store("ir", Object(object));
+    }
+    auto cache = Cache();
+    const auto loaded = cache.load("ir");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getBuffer(), object);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 0);
+}
+
+TEST_F(ObjectCacheTest, KeysByIrAndTarget) {
+    Cache().store("ir", Object("object"));
+    EXPECT_EQ(Cache().load("other ir"), nullptr);
+
+    options.opt_level = OptLevel::O3;
+    EXPECT_EQ(Cache().load("ir"), nullptr);
+    options.opt_level = OptLevel::O2;
+
+    options.target_features = "-sse4.2";
+    EXPECT_EQ(Cache().load("ir"), nullptr);
+    options.target_features.clear();
+
+    options.target_cpu = "generic";
+    EXPECT_EQ(Cache().load("ir"), nullptr);
+    options.target_cpu.clear();
+
+    EXPECT_NE(Cache().load("ir"), nullptr);
+}
+
+TEST_F(ObjectCacheTest, CachesJitModules) {
+    llvm::LLVMContext ctx;
+    llvm::Module module("m", ctx);
+    llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(ctx), false),
+                           llvm::Function::ExternalLinkage, "f", module);
+    const std::string object = "object of m";
+    {
+        auto cache = Cache();
+        EXPECT_EQ(cache.getObject(&module), nullptr);
+        cache.notifyObjectCompiled(&module, Object(object));
+    }
+    auto cache = Cache();
+    const auto loaded = cache.getObject(&module);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getBuffer(), object);
+    EXPECT_EQ(cache.hits(), 1);
+
+    // Changed IR misses
+    llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(ctx), false),
+                           llvm::Function::ExternalLinkage, "g", module);
+    EXPECT_EQ(cache.getObject(&module), nullptr);
+}
+
+// Compiles successive versions of one module against the same cache directory
+class IncrementalTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "arco_incremental_test";
+    TypeInterner types;
+    CompilerOptions options;
+    size_t reused = 0;
+    size_t compiled = 0;
+
+    static void SetUpTestSuite() {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+    }
+
+    void SetUp() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> Compile(const std::vector<std::string>& in) {
+        SourceFile file(in);
+        Module module("testing", types, options);
+        module.parse(file);
+        module.run_sema();
+        module.run_type_checker();
+        module.run_codegen();
+        IncrementalCompiler compiler(dir, options);
+        auto objects = compiler.compile(module);
+        reused = compiler.reused();
+        compiled = compiler.compiled();
+        return objects;
+    }
+};
+
+
+TEST_F(IncrementalTest, ReusesUnchangedFunctions) {
+    const std::vector<std::string> src = {
+        "fun f() of int = 1",
+        "fun g() of int = f() + 1",
+        "fun h(a of int) of int = a * 2",
+    };
+    EXPECT_EQ(Compile(src).size(), 3);
+    EXPECT_EQ(compiled, 3);
+    EXPECT_EQ(reused, 0);
+
+    EXPECT_EQ(Compile(src).size(), 3);
+    EXPECT_EQ(compiled, 0);
+    EXPECT_EQ(reused, 3);
+}
+
+TEST_F(IncrementalTest, RecompilesOnlyEditedFunctions) {
+    Compile({
+        "fun f() of int = 1",
+        "fun g() of int = f() + 1",
+        "fun h(a of int) of int = a * 2",
+    });
+    Compile({
+        "fun f() of int = 1",
+        "fun g() of int = f() + 1",
+        "fun h(a of int) of int = a * 3",
+    });
+    EXPECT_EQ(compiled, 1);
+    EXPECT_EQ(reused, 2);
+}
+
+TEST_F(IncrementalTest, RecompilesCallersOfChangedSignatures) {
+    Compile({
+        "fun f() of int = 1",
+        "fun g() of int = {",
+        "    let r = f()",
+        "    0",
+        "}",
+        "fun h(a of int) of int = a * 2",
+    });
+    // g's source is unchanged, but it declares f with the new return type
+    Compile({
+        "fun f() of bool = true",
+        "fun g() of int = {",
+        "    let r = f()",
+        "    0",
+        "}",
+        "fun h(a of int) of int = a * 2",
+    });
+    EXPECT_EQ(compiled, 2);
+    EXPECT_EQ(reused, 1);
+}
+
+TEST_F(IncrementalTest, NumbersConstantsPerFunction) {
+    const std::vector<std::string> a = {"fun a() of int = {", "    printf(\"shared\\n\")", "    1", "}"};
+    const std::vector<std::string> b = {"fun b() of int = {", "    printf(\"shared\\n\")", "    2", "}"};
+    const std::vector<std::string> c = {"fun c() of int = {", "    printf(\"new\\n\")", "    3", "}"};
+    std::vector<std::string> src = a;
+    src.insert(src.end(), b.begin(), b.end());
+    Compile(src);
+    EXPECT_EQ(compiled, 2);
+
+    // The new literal comes first in the module, but doesn't shift the names of the others
+    src.insert(src.begin(), c.begin(), c.end());
+    auto objects = Compile(src);
+    EXPECT_EQ(compiled, 1);
+    EXPECT_EQ(reused, 2);
+
+    // Each object has its own const.0, which mustn't clash when they are linked
+    ASSERT_EQ(objects.size(), 3);
+    EXPECT_TRUE(objects[1]->getBuffer().contains("shared"));
+    EXPECT_TRUE(objects[2]->getBuffer().contains("shared"));
+    auto jit = cantFail(llvm::orc::LLJITBuilder().create());
+    jit->getMainJITDylib().addGenerator(
+        cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            jit->getDataLayout().getGlobalPrefix())));
+    for (auto& object : objects) {
+        cantFail(jit->addObjectFile(std::move(object)));
+    }
+    using IntFn = int();
+    const auto a_addr = cantFail(jit->lookup("a"));
+    const auto b_addr = cantFail(jit->lookup("b"));
+    const auto c_addr = cantFail(jit->lookup("c"));
+    EXPECT_EQ(a_addr.toPtr<IntFn>()(), 1);
+    EXPECT_EQ(b_addr.toPtr<IntFn>()(), 2);
+    EXPECT_EQ(c_addr.toPtr<IntFn>()(), 3);
+}
@@ -1,22 +1,35 @@
+#include <fstream>
 #include <gtest/gtest.h>
 #include "lexer.h"
 #include "source_file.h"
 #include "token.h"
 #include "token_type.h"
 
-class LexerTest : public ::testing::Test {
+// Every lexer test runs in both modes
+class LexerTest : public ::testing::TestWithParam<LexMode> {
 protected:
     std::unique_ptr<SourceFile> file;
     std::unique_ptr<Lexer> lexer;
 
     void SetUpInput(const std::vector<std::string>& input) {
         file = std::make_unique<SourceFile>(input);
-        lexer = std::make_unique<Lexer>(*file);
+        lexer = std::make_unique<Lexer>(*file, GetParam());
+    }
+
+    std::vector<Token> lex_all() {
+        std::vector<Token> tokens;
+        do {
+            tokens.push_back(lexer->advance());
+        } while (tokens.back().type != TokenType::Eof);
+        return tokens;
     }
 };
 
+INSTANTIATE_TEST_SUITE_P(Modes, LexerTest, ::testing::Values(LexMode::Scalar, LexMode::Simd),
+    [](const auto& info) { return info.param == LexMode::Scalar ? "Scalar" : "Simd"; });
+
 
-TEST_F(LexerTest, SkipsComments) {
+TEST_P(LexerTest, SkipsComments) {
     SetUpInput({"2.5#Comment", "2"});
     const Token t1 = lexer->advance();
     EXPECT_EQ(t1.type, TokenType::FloatConst);
@@ -24,7 +37,7 @@ TEST_F(LexerTest, SkipsComments) {
     EXPECT_EQ(t2.type, TokenType::Newline);
 }
 
-TEST_F(LexerTest, HandlesNewlineAndEOF) {
+TEST_P(LexerTest, HandlesNewlineAndEOF) {
     SetUpInput({"2"});
     lexer->advance();
     Token t = lexer->advance();
@@ -33,7 +46,7 @@ TEST_F(LexerTest, HandlesNewlineAndEOF) {
     EXPECT_EQ(t.type, TokenType::Eof);
 }
 
-TEST_F(LexerTest, RecognizesNumLiterals) {
+TEST_P(LexerTest, RecognizesNumLiterals) {
     SetUpInput({"2 2.5"});
     const Token intLiteral = lexer->advance();
     const Token floatLiteral = lexer->advance();
@@ -44,7 +57,7 @@ TEST_F(LexerTest, RecognizesNumLiterals) {
     EXPECT_EQ(floatLiteral.type, TokenType::FloatConst);
 }
 
-TEST_F(LexerTest, RecognizesKeywords) {
+TEST_P(LexerTest, RecognizesKeywords) {
     SetUpInput({"let x"});
     const Token keyword = lexer->advance();
     const Token id = lexer->advance();
@@ -54,19 +67,57 @@ TEST_F(LexerTest, RecognizesKeywords) {
 }
 
 
-TEST_F(LexerTest, CharLiteralHandlesEscapeChar) {
+TEST_P(LexerTest, DistinguishesKeywordsFromIdentifiers) {
+    SetUpInput({"while whilst internal internals of o If if"});
+    const std::vector<TokenType> expected = {
+        TokenType::While, TokenType::Id, TokenType::Internal, TokenType::Id,
+        TokenType::Of, TokenType::Id, TokenType::Id, TokenType::If};
+    for (const auto type : expected) {
+        EXPECT_EQ(lexer->advance().type, type);
+    }
+}
+
+TEST(KeywordTest, RecognizesEveryKeyword) {
+    for (auto t = static_cast<size_t>(first_keyword); t <= static_cast<size_t>(last_keyword); t++) {
+        const auto type = static_cast<TokenType>(t);
+        const std::string kw = str_of_type(type);
+        EXPECT_TRUE(is_keyword(kw)) << kw;
+        EXPECT_EQ(keyword_type(kw), type) << kw;
+    }
+    EXPECT_EQ(keyword_type(""), TokenType::Id);
+    EXPECT_EQ(keyword_type("fun_"), TokenType::Id);
+}
+
+TEST_P(LexerTest, CharLiteralHandlesEscapeChar) {
     SetUpInput({"'\\t'"});
     const Token t= lexer->advance();
     EXPECT_EQ("\t", t.lexeme);
 }
 
-TEST_F(LexerTest, StrLiteralHandlesEscapeChar) {
+TEST_P(LexerTest, StrLiteralHandlesEscapeChar) {
     SetUpInput({R"("hi\t")"});
     Token t = lexer->advance();
     EXPECT_EQ("hi\t", t.lexeme);
 }
 
-TEST_F(LexerTest, HandlesTwoCharSymbols) {
+TEST_P(LexerTest, LexemesPointIntoSource) {
+    SetUpInput({R"(foo "bar")"});
+    const Token id = lexer->advance();
+    const Token str = lexer->advance();
+    const auto text = file->text();
+    EXPECT_EQ(id.lexeme.data(), text.data());
+    EXPECT_EQ(str.lexeme, "bar");
+    EXPECT_EQ(str.lexeme.data(), text.data() + 5);
+}
+
+TEST_P(LexerTest, CharLiteralHandlesNullEscape) {
+    SetUpInput({"'\\0'"});
+    const Token t = lexer->advance();
+    ASSERT_EQ(t.lexeme.size(), 1);
+    EXPECT_EQ(t.lexeme[0], '\0');
+}
+
+TEST_P(LexerTest, HandlesTwoCharSymbols) {
     SetUpInput({"(<="});
     const Token lp = lexer->advance();
     const Token lt = lexer->advance();
@@ -75,18 +126,135 @@ TEST_F(LexerTest, HandlesTwoCharSymbols) {
     EXPECT_EQ(lt.type, TokenType::LessEqual);
 }
 
-TEST_F(LexerTest, SetsPosition) {
+TEST_P(LexerTest, SetsPosition) {
     SetUpInput({"let"});
     const Token l = lexer->advance();
-    EXPECT_EQ(l.loc.start.column, 1);
-    EXPECT_EQ(l.loc.start.line, 1);
-    EXPECT_EQ(l.loc.end.column, 4);
+    EXPECT_EQ(l.loc.start().column, 1);
+    EXPECT_EQ(l.loc.start().line, 1);
+    EXPECT_EQ(l.loc.end().column, 4);
 }
 
-TEST_F(LexerTest, PositionOfNewline) {
+TEST_P(LexerTest, PositionOfNewline) {
     SetUpInput({"2"});
     lexer->advance();
     const auto nl = lexer->advance();
-    EXPECT_EQ(nl.loc.start, Position(1, 2));
-    EXPECT_EQ(nl.loc.end, Position(1, 3));
-}
\ No newline at end of file
+    EXPECT_EQ(nl.loc.start(), Position(1, 2));
+    EXPECT_EQ(nl.loc.end(), Position(1, 3));
+}
+
+TEST_P(LexerTest, ContinuesAfterComment) {
+    SetUpInput({"x # Comment", "y"});
+    EXPECT_EQ(lexer->advance().type, TokenType::Id);
+    EXPECT_EQ(lexer->advance().type, TokenType::Newline);
+    const Token y = lexer->advance();
+    EXPECT_EQ(y.type, TokenType::Id);
+    EXPECT_EQ(y.lexeme, "y");
+    EXPECT_EQ(y.loc.start(), Position(2, 1));
+}
+TEST_P(LexerTest, HandlesRunsAcrossBlocks) {
+    const std::string id(70, 'a');
+    const std::string body(45, 'x');
+    SetUpInput({std::string(40, ' ') + id + "_9 " + std::string(37, '7') + ".25",
+                "\"" + body + "\\t" + body + "\" \"" + body + "\""});
+    const auto tokens = lex_all();
+    ASSERT_EQ(tokens.size(), 7);
+    EXPECT_EQ(tokens[0].lexeme, id + "_9");
+    EXPECT_EQ(tokens[0].loc.start(), Position(1, 41));
+    EXPECT_EQ(tokens[1].type, TokenType::FloatConst);
+    EXPECT_EQ(tokens[1].lexeme, std::string(37, '7') + ".25");
+    EXPECT_EQ(tokens[2].type, TokenType::Newline);
+    EXPECT_EQ(tokens[3].lexeme, body + "\t" + body);
+    EXPECT_EQ(tokens[4].lexeme, body);
+    EXPECT_EQ(tokens[4].loc.end().column, 98 + static_cast<int>(body.size()));
+}
+
+TEST(LexModeTest, ModesProduceSameTokens) {
+    const SourceFile file({
+        "fun main() of int = {",
+        "    let s = \"a long string literal with an \\\"escape\\\" inside\"   # comment",
+        "\tvar counter_with_a_long_name_1 = 1234567890 + 3.14159 * (2 - 1)",
+        "    while counter_with_a_long_name_1 <= 10 { counter_with_a_long_name_1 = counter_with_a_long_name_1 + 1 }",
+        "    printf(\"%d %c\\n\", counter_with_a_long_name_1, '\\t')",
+        "    0",
+        "}"});
+    Lexer scalar(const_cast<SourceFile&>(file), LexMode::Scalar);
+    Lexer simd(const_cast<SourceFile&>(file), LexMode::Simd);
+    while (true) {
+        const Token a = scalar.advance();
+        const Token b = simd.advance();
+        ASSERT_EQ(a.to_string(), b.to_string());
+        if (a.type == TokenType::Eof) {
+            break;
+        }
+    }
+}
+
+TEST(SourceFileTest, ExposesLinesAsViews) {
+    const SourceFile file({"let x = 1", "", "x"});
+    EXPECT_EQ(file.length(), 3);
+    EXPECT_EQ(file.get_line(1), "let x = 1\n");
+    EXPECT_EQ(file.get_line(2), "\n");
+    EXPECT_EQ(file.get_line(3), "x\n");
+    EXPECT_EQ(file.line_offset(3), 11);
+    EXPECT_EQ(file.text(), "let x = 1\n\nx\n");
+}
+
+TEST(SourceFileTest, ReadsFileWithoutTrailingNewline) {
+    const std::string path = ::testing::TempDir() + "arco_source_file_test.arc";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "fun\n\nmain";
+    }
+    const SourceFile file(path);
+    EXPECT_EQ(file.length(), 3);
+    EXPECT_EQ(file.get_line(3), "main\n");
+    EXPECT_EQ(file.text().back(), '\n');
+    std::remove(path.c_str());
+}
+
+TEST(SourceFileTest, MapsFileEndingWithNewline) {
+    const std::string path = ::testing::TempDir() + "arco_source_file_mapped.arc";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "let x = 1\nx\n";
+    }
+    const SourceFile file(path);
+    EXPECT_EQ(file.length(), 2);
+    EXPECT_EQ(file.get_line(1), "let x = 1\n");
+    EXPECT_EQ(file.get_line(2), "x\n");
+    std::remove(path.c_str());
+}
+
+TEST(SourceFileTest, LocationsFindTheirFile) {
+    SourceFile first(std::vector<std::string>{"let x = 1", "x"});
+    SourceFile second(std::vector<std::string>{"a", "  bc"});
+    const Location in_first(first, 10, 1);
+    const Location in_second(second, 4, 2);
+
+    EXPECT_EQ(&in_first.src(), &first);
+    EXPECT_EQ(&in_second.src(), &second);
+    EXPECT_EQ(in_second.offset(), 4);
+    EXPECT_EQ(in_first.start(), Position(2, 1));
+    EXPECT_EQ(in_second.start(), Position(2, 3));
+    EXPECT_EQ(in_second.end(), Position(2, 5));
+}
+
+TEST_P(LexerTest, LocatesEofOnLastLine) {
+    SetUpInput({"x", "y"});
+    const auto tokens = lex_all();
+    ASSERT_EQ(tokens.back().type, TokenType::Eof);
+    EXPECT_EQ(tokens.back().loc.offset(), 4);
+    EXPECT_EQ(tokens.back().loc.start(), Position(2, 3));
+}
+
+TEST_P(LexerTest, InternsIdentifiers) {
+    SetUpInput({"foo bar foo", "let"});
+    const auto tokens = lex_all();
+    ASSERT_EQ(tokens[0].type, TokenType::Id);
+    EXPECT_EQ(tokens[0].ident, tokens[2].ident);
+    EXPECT_NE(tokens[0].ident, tokens[1].ident);
+    EXPECT_EQ(tokens[0].ident, intern("foo"));
+    EXPECT_EQ(tokens[1].ident.str(), "bar");
+    EXPECT_EQ(tokens[4].type, TokenType::Let);
+    EXPECT_EQ(tokens[4].ident, Ident{});
+}
@@ -2,18 +2,29 @@
 
 #include <gtest/gtest.h>
 
+#include "arena.h"
 #include "expr_nodes.h"
+#include "flat_ast.h"
+#include "lexer.h"
+#include "module_collector.h"
+#include "name_resolution.h"
 #include "source_file.h"
+#include "stmt_nodes.h"
+#include "symbol.h"
+#include "syntax_error.h"
+#include "token_buffer.h"
+#include "token_type.h"
 
 
 class ParserTest : public ::testing::Test {
 protected:
+    Arena arena;
     std::unique_ptr<SourceFile> file;
     std::unique_ptr<Parser> parser;
 
     void SetUpInput(const std::vector<std::string>& in) {
         file = std::make_unique<SourceFile>(in);
-        parser = std::make_unique<Parser>(*file);
+        parser = std::make_unique<Parser>(*file, arena);
     }
 };
 
@@ -25,7 +36,7 @@ TEST_F(ParserTest, HandlesEmptyFile) {
 
 TEST_F(ParserTest, ParsesIntConst) {
     SetUpInput({"2"});
-    const std::unique_ptr<Expr> cons = parser->parse_expr();
+    const ExprPtr cons = parser->parse_expr();
     const auto int_const = dynamic_cast<IntConst*>(cons.get());
     ASSERT_NE(int_const, nullptr);
     EXPECT_EQ(int_const->val, 2);
@@ -33,7 +44,7 @@ TEST_F(ParserTest, ParsesIntConst) {
 
 TEST_F(ParserTest, ParsesFloatConst) {
     SetUpInput({"2.5"});
-    const std::unique_ptr<Expr> cons = parser->parse_expr();
+    const ExprPtr cons = parser->parse_expr();
     const auto int_const = dynamic_cast<FloatConst*>(cons.get());
     ASSERT_NE(int_const, nullptr);
     EXPECT_EQ(int_const->val, 2.5);
@@ -55,4 +66,162 @@ TEST_F(ParserTest, HandlesOperatorPrecedence) {
     const auto binary_expr = dynamic_cast<BinaryExpr*>(expr.get());
     ASSERT_NE(binary_expr, nullptr);
     EXPECT_EQ(binary_expr->op, BinaryOp::Add);
-}
\ No newline at end of file
+}
+
+TEST_F(ParserTest, ParsesAssignmentWithLookahead) {
+    SetUpInput({"x = 2", "x"});
+    const StmtPtr assignment = parser->parse_stmt();
+    const auto* a = dynamic_cast<Assignment*>(assignment.get());
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a->assignee.str(), "x");
+    const StmtPtr expr_stmt = parser->parse_stmt();
+    ASSERT_NE(dynamic_cast<ExprStmt*>(expr_stmt.get()), nullptr);
+}
+
+TEST_F(ParserTest, ParsesImportAndQualifiedCall) {
+    SetUpInput({"import math", "math.square(2)"});
+    const StmtPtr import = parser->parse_stmt();
+    const auto* i = dynamic_cast<ImportStmt*>(import.get());
+    ASSERT_NE(i, nullptr);
+    EXPECT_EQ(i->name.str(), "math");
+    const StmtPtr stmt = parser->parse_stmt();
+    const auto* expr_stmt = dynamic_cast<ExprStmt*>(stmt.get());
+    ASSERT_NE(expr_stmt, nullptr);
+    const auto* call = dynamic_cast<FunCall*>(expr_stmt->expr.get());
+    ASSERT_NE(call, nullptr);
+    EXPECT_EQ(call->qualifier.str(), "math");
+    EXPECT_EQ(call->callee.str(), "square");
+    EXPECT_EQ(call->args.size(), 1);
+}
+
+TEST(TokenBufferTest, MatchesLexerTokens) {
+    SourceFile file({"fun f(a of int) of string = {", "  let s = \"tab\\there\"   # comment", "  'x' ^ s", "}"});
+    const TokenBuffer tokens(file);
+    Lexer lexer(file);
+    for (size_t i = 0; i < tokens.size(); i++) {
+        EXPECT_EQ(tokens.get(i).to_string(), lexer.advance().to_string());
+    }
+    EXPECT_EQ(tokens.type(tokens.size() + 5), TokenType::Eof);
+}
+
+TEST(TokenBufferTest, ReportsLexerErrorsWhenReached) {
+    SourceFile file(std::vector<std::string>{"fun f() of int = )", "let x = $"});
+    const TokenBuffer tokens(file);
+    ASSERT_EQ(tokens.type(tokens.size() - 1), TokenType::Error);
+    Arena arena;
+    try {
+        parse_file(tokens, arena);
+        FAIL();
+    } catch (const SyntaxError& e) {
+        EXPECT_NE(std::string(e.what()).find("testing:1:"), std::string::npos);
+    }
+}
+
+TEST_F(ParserTest, AllocatesNodesInArena) {
+    SetUpInput({"print(\"a\\tb\", x + 1)"});
+    const auto expr = parser->parse_expr();
+    const auto* call = dynamic_cast<FunCall*>(expr.get());
+    ASSERT_NE(call, nullptr);
+    const auto* str = dynamic_cast<StringConst*>(call->args[0].get());
+    ASSERT_NE(str, nullptr);
+    EXPECT_EQ(str->val, "a\tb");
+    EXPECT_EQ(call->args.get_allocator().resource(), &arena);
+    EXPECT_GE(arena.bytes_allocated(), sizeof(FunCall) + sizeof(StringConst) + sizeof(BinaryExpr));
+    EXPECT_GE(arena.bytes_reserved(), arena.bytes_allocated());
+}
+
+TEST(FlatAstTest, NumbersChildrenBeforeParents) {
+    SourceFile file(std::vector<std::string>{"fun f(x of int) of int = { let y = x * 2; if y > 3 then { y; } else { -y; }; }",
+                                             "f(1 + 2)"});
+    Arena arena;
+    const auto ast = parse_file(file, arena);
+    const FlatAst flat = flatten(ast);
+
+    ASSERT_EQ(flat.roots.size(), 2);
+    EXPECT_EQ(flat.kind(flat.roots[0]), NodeKind::FunDef);
+    EXPECT_EQ(flat.roots[1], flat.size() - 1);
+    for (NodeId id = 0; id < flat.size(); id++) {
+        switch (flat.kind(id)) {
+            case NodeKind::Binary:
+                EXPECT_LT(flat.binary(id).lhs, flat.binary(id).rhs);
+                EXPECT_LT(flat.binary(id).rhs, id);
+                break;
+            case NodeKind::Block:
+                for (const NodeId stmt : flat.body(id)) {
+                    EXPECT_LT(stmt, id);
+                }
+                break;
+            case NodeKind::IfElse:
+                EXPECT_LT(flat.if_else(id).else_branch, id);
+                break;
+            default:
+                break;
+        }
+    }
+
+    const auto& fun = flat.fun(flat.roots[0]);
+    EXPECT_EQ(fun.id.str(), "f");
+    ASSERT_EQ(flat.fun_params(flat.roots[0]).size(), 1);
+    EXPECT_EQ(flat.fun_params(flat.roots[0])[0].id.str(), "x");
+    EXPECT_EQ(flat.kind(fun.body), NodeKind::Block);
+    EXPECT_EQ(flat.block(fun.body).scope, &dynamic_cast<BlockExpr*>(dynamic_cast<FunDef*>(ast[0].get())->body.get())->scope);
+
+    const NodeId call = flat.child(flat.roots[1]);
+    ASSERT_EQ(flat.kind(call), NodeKind::FunCall);
+    EXPECT_EQ(flat.call(call).callee, intern("f"));
+    ASSERT_EQ(flat.args(call).size(), 1);
+    const auto& sum = flat.binary(flat.args(call)[0]);
+    EXPECT_EQ(sum.op, BinaryOp::Add);
+    EXPECT_EQ(flat.int_val(sum.lhs), 1);
+    EXPECT_EQ(flat.int_val(sum.rhs), 2);
+    EXPECT_EQ(flat.locs[call].start().line, 2);
+}
+
+TEST(FlatAstTest, StoresConstants) {
+    SourceFile file(std::vector<std::string>{"var s = \"a\\nb\"", "let c = '\\t'", "let d = -2.5", "let b = false",
+                                             "let i = -7"});
+    Arena arena;
+    const FlatAst flat = flatten(parse_file(file, arena));
+
+    ASSERT_EQ(flat.roots.size(), 5);
+    EXPECT_EQ(flat.str(flat.var(flat.roots[0]).val), "a\nb");
+    EXPECT_FALSE(flat.var(flat.roots[0]).is_const);
+    EXPECT_EQ(flat.char_val(flat.var(flat.roots[1]).val), '\t');
+    EXPECT_EQ(flat.float_val(flat.unary(flat.var(flat.roots[2]).val).operand), 2.5);
+    EXPECT_FALSE(flat.bool_val(flat.var(flat.roots[3]).val));
+    EXPECT_EQ(flat.int_val(flat.unary(flat.var(flat.roots[4]).val).operand), 7);
+}
+
+TEST(FlatAstTest, CarriesResolvedSymbols) {
+    SourceFile file(std::vector<std::string>{"fun f(a of int) of int = { var b = a; b = b + 1; b; }"});
+    Arena arena;
+    const auto ast = parse_file(file, arena);
+    Scope module_scope(Scope::Kind::Module, arena);
+    ModuleCollector mc(module_scope);
+    NameResolution nr(&module_scope);
+    mc.dispatch(*ast[0]);
+    nr.dispatch(*ast[0]);
+    const FlatAst flat = flatten(ast);
+
+    auto& f = dynamic_cast<FunDef&>(*ast[0]);
+    const auto& var = dynamic_cast<VarInit&>(*dynamic_cast<BlockExpr&>(*f.body).body[0]);
+    const NodeId root = flat.roots[0];
+    EXPECT_EQ(flat.syms[root], f.signature.sym);
+    EXPECT_EQ(flat.fun_params(root)[0].sym, f.signature.args[0].sym);
+    for (NodeId id = 0; id < flat.size(); id++) {
+        switch (flat.kind(id)) {
+            case NodeKind::Id:
+                EXPECT_EQ(flat.syms[id], flat.ident(id) == intern("a") ? f.signature.args[0].sym : var.sym);
+                break;
+            case NodeKind::VarInit:
+            case NodeKind::Assignment:
+                EXPECT_EQ(flat.syms[id], var.sym);
+                break;
+            case NodeKind::IntConst:
+                EXPECT_EQ(flat.syms[id], nullptr);
+                break;
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include "symbol_table.h"
+
+#include <gtest/gtest.h>
+
+#include "arena.h"
+#include "expr_nodes.h"
+#include "interner.h"
+#include "lexer.h"
+#include "module_collector.h"
+#include "name_resolution.h"
+#include "parser.h"
+#include "scope.h"
+#include "source_file.h"
+#include "stmt_nodes.h"
+#include "symbol.h"
+
+
+TEST(SymbolTableTest, GrowsPastInlineEntries) {
+    Arena arena;
+    SymbolTable table(arena);
+    SourceFile file(std::vector<std::string>{"a"});
+    const Token id = Lexer(file).advance();
+    DefArg arg(id, TypeAnno(id.loc, TypeAnno::Kind::Int));
+    std::vector<Symbol*> symbols;
+    for (int i = 0; i < 100; i++) {
+        const Ident id = intern("sym" + std::to_string(i));
+        symbols.push_back(arena.make<Symbol>(ParamSymbol(arg)).release());
+        ASSERT_TRUE(table.insert(id, symbols.back()));
+        ASSERT_FALSE(table.insert(id, symbols.back()));
+        for (int j = 0; j <= i; j++) {
+            ASSERT_EQ(table.find(intern("sym" + std::to_string(j))), symbols[j]);
+        }
+    }
+    EXPECT_EQ(table.size(), 100);
+    EXPECT_EQ(table.find(intern("missing")), nullptr);
+}
+
+TEST(NameResolutionTest, BindsUsesToTheirDefinitions) {
+    SourceFile file(std::vector<std::string>{
+        "fun f(a of int) of int = {",
+        "    var b = a",
+        "    b = g(b)",
+        "    b",
+        "}",
+        "fun g(x of int) of int = x",
+    });
+    Arena arena;
+    const auto ast = parse_file(file, arena);
+    Scope module_scope(Scope::Kind::Module, arena);
+    ModuleCollector mc(module_scope);
+    NameResolution nr(&module_scope);
+    for (const auto& node : ast) {
+        mc.dispatch(*node);
+    }
+    for (const auto& node : ast) {
+        nr.dispatch(*node);
+    }
+
+    auto& f = dynamic_cast<FunDef&>(*ast[0]);
+    auto& g = dynamic_cast<FunDef&>(*ast[1]);
+    const auto& body = dynamic_cast<BlockExpr&>(*f.body).body;
+    auto& var = dynamic_cast<VarInit&>(*body[0]);
+    auto& assign = dynamic_cast<Assignment&>(*body[1]);
+    ASSERT_NE(var.sym, nullptr);
+    EXPECT_EQ(dynamic_cast<IdExpr&>(*var.val).sym, f.signature.args[0].sym);
+    EXPECT_EQ(assign.sym, var.sym);
+    EXPECT_EQ(dynamic_cast<FunCall&>(*assign.val).sym, g.signature.sym);
+    EXPECT_EQ(module_scope.resolve(intern("g")), g.signature.sym);
+    EXPECT_TRUE(var.sym->is_reassigned);
+    EXPECT_FALSE(f.signature.args[0].sym->is_reassigned);
+}
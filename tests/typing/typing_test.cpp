@@ -0,0 +1,24 @@
+#include "type_interner.h"
+
+#include <gtest/gtest.h>
+
+#include "type.h"
+
+
+TEST(TypeInternerTest, HashConsesFunctionTypes) {
+    TypeInterner types;
+    Type* int_ty = types.basic(BasicTy::Kind::Int);
+    Type* float_ty = types.basic(BasicTy::Kind::Float);
+    EXPECT_EQ(int_ty, types.basic(BasicTy::Kind::Int));
+
+    std::vector<Type*> args{int_ty, float_ty};
+    Type* f = types.function(args, int_ty);
+    args.push_back(int_ty);
+    EXPECT_NE(types.function(args, int_ty), f);
+    args.pop_back();
+    EXPECT_EQ(types.function(args, int_ty), f);
+    EXPECT_NE(types.function(args, float_ty), f);
+    EXPECT_EQ(types.function({}, f), types.function({}, f));
+    EXPECT_EQ(types.function_count(), 4);
+    EXPECT_EQ(f->to_string(), "(int, float) -> int");
+}